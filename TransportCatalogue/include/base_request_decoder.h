@@ -0,0 +1,209 @@
+#pragma once
+
+#include "geo.h"
+#include "json_sax.h"
+#include "ranges.h"
+#include "transport_catalogue.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Запрос Stop раздела base_requests
+struct StopRequest {
+    using DistanceRange = ranges::Range<std::vector<std::pair<std::string, int>>::const_iterator>;
+
+    std::string_view name;
+    geo::Coordinates coordinates;
+    DistanceRange road_distances;   // Пары (остановка, расстояние в метрах)
+};
+
+// Запрос Bus раздела base_requests
+struct BusRequest {
+    using StopNameRange = ranges::Range<std::vector<std::string>::const_iterator>;
+
+    std::string_view number;
+    StopNameRange stops;
+    bool is_roundtrip = false;
+};
+
+// Получатель запросов, распознанных BaseRequestDecoder. Данные запроса действительны
+// только на время вызова
+class BaseRequestSink {
+public:
+    virtual ~BaseRequestSink() = default;
+
+    virtual void AddStop(const StopRequest& request) = 0;
+    virtual void AddBus(const BusRequest& request) = 0;
+};
+
+// Заполняет каталог запросами в порядке их поступления: остановки добавляются сразу,
+// маршруты - как только известны все их остановки. Ссылки на ещё не описанные остановки
+// (в road_distances и stops) откладываются и разрешаются в Finish()
+class CatalogueFiller final : public BaseRequestSink {
+public:
+    explicit CatalogueFiller(transport::Catalogue& catalogue);
+
+    void AddStop(const StopRequest& request) override;
+    void AddBus(const BusRequest& request) override;
+
+    // Разрешает отложенные ссылки и добавляет отложенные маршруты.
+    // Если остановка так и не описана, выбрасывает std::invalid_argument
+    void Finish();
+
+private:
+    // Расстояние до остановки, описанной позже
+    struct PendingDistance {
+        uint32_t from_id;
+        std::string to;
+        int distance;
+    };
+
+    // Маршрут, добавление которого отложено до описания всех остановок
+    struct PendingBus {
+        std::string number;
+        std::vector<std::string> stops;
+        bool is_roundtrip;
+    };
+
+    transport::Catalogue& catalogue_;
+    std::vector<const transport::Stop*> route_stops_;
+    std::vector<PendingDistance> pending_distances_;
+    std::vector<PendingBus> pending_buses_;    // Маршруты в порядке ввода, начиная с первого отложенного
+};
+
+// Запросы части раздела, сохранённые в порядке ввода. Фрагменты частей, разобранных параллельно,
+// переносятся в каталог в три шага: остановки всех фрагментов по порядку, затем поиск остановок
+// по именам (каталог только читается, поэтому фрагменты обрабатываются параллельно), затем
+// расстояния и маршруты по порядку. Результат не зависит от числа потоков
+class BaseRequestFragment final : public BaseRequestSink {
+public:
+    void AddStop(const StopRequest& request) override;
+    void AddBus(const BusRequest& request) override;
+
+    // Добавляет остановки фрагмента в каталог в порядке ввода
+    void AddStopsTo(transport::Catalogue& catalogue);
+    // Находит остановки расстояний и маршрутов фрагмента. Если остановка не описана,
+    // выбрасывает std::invalid_argument
+    void ResolveStops(const transport::Catalogue& catalogue);
+    // Задаёт расстояния до остановок, описанных не позже исходной (backward), или до описанных позже.
+    // Расстояния задаются в том же порядке, что и при последовательном заполнении CatalogueFiller
+    void AddDistancesTo(transport::Catalogue& catalogue, bool backward) const;
+    // Добавляет маршруты фрагмента в порядке ввода
+    void AddRoutesTo(transport::Catalogue& catalogue) const;
+
+private:
+    // Запрос; его расстояния (для Stop) или остановки (для Bus) лежат в общем векторе до позиции end
+    struct Request {
+        bool is_stop;
+        std::string name;
+        geo::Coordinates coordinates;
+        bool is_roundtrip;
+        size_t end;
+    };
+
+    std::vector<Request> requests_;
+    std::vector<std::pair<std::string, int>> distances_;
+    std::vector<std::string> stops_;
+
+    // Заполняются при переносе в каталог
+    uint32_t first_stop_id_ = 0;                          // Идентификатор первой остановки фрагмента
+    std::vector<const transport::Stop*> distance_stops_;  // Остановки distances_
+    std::vector<const transport::Stop*> route_stops_;     // Остановки stops_
+};
+
+// Декодер раздела base_requests, передающий запросы Stop и Bus получателю прямо по событиям
+// потокового разбора, без построения дерева узлов. Запросы распознаются по ключам;
+// неизвестные ключи и запросы других типов пропускаются
+class BaseRequestDecoder final : public json::Handler {
+public:
+    explicit BaseRequestDecoder(BaseRequestSink& sink);
+
+    // Разбор начинается с элементов массива запросов, без события StartArray
+    // (часть раздела, разбираемая json::ParseArrayItems)
+    void StartInsideArray();
+
+    void StartObject() override;
+    void Key(std::string_view key) override;
+    void EndObject() override;
+
+    void StartArray() override;
+    void EndArray() override;
+
+    void String(std::string_view value) override;
+    void Int(int value) override;
+    void Double(double value) override;
+    void Bool(bool value) override;
+    void Null() override;
+
+private:
+    // Положение разбора в схеме раздела
+    enum class State {
+        START,       // Ожидается массив запросов
+        REQUESTS,    // Внутри массива запросов
+        REQUEST,     // Внутри словаря запроса
+        DISTANCES,   // Внутри road_distances
+        STOPS,       // Внутри stops
+        DONE         // Массив запросов разобран
+    };
+
+    // Поле запроса, значение которого ожидается
+    enum class Field {
+        NONE,
+        TYPE,
+        NAME,
+        LATITUDE,
+        LONGITUDE,
+        ROAD_DISTANCES,
+        STOPS,
+        IS_ROUNDTRIP
+    };
+
+    enum class RequestType {
+        UNKNOWN,
+        STOP,
+        BUS
+    };
+
+    // Пропускает значение неизвестного ключа; возвращает true, если событие относится к нему
+    bool Skip(int delta);
+    // Обрабатывает значение, недопустимое в текущем состоянии. Вне запроса это ошибка разбора,
+    // а внутри запроса она запоминается: запросы неизвестных типов не проверяются
+    void Unexpected(std::string_view what);
+    // Записывает число в поле запроса
+    void SetNumber(double value);
+    // Копирует строку в слот count переиспользуемого набора строк
+    static void StoreString(std::vector<std::string>& slots, size_t& count, std::string_view value);
+
+    void BeginRequest();
+    void EndRequest();
+
+    BaseRequestSink& sink_;
+    State state_ = State::START;
+    Field field_ = Field::NONE;
+    int skip_depth_ = 0;          // Вложенность пропускаемого значения
+
+    // Поля текущего запроса. Векторы не сжимаются, поэтому их строки переиспользуются
+    // от запроса к запросу; используются первые distances_count_ и stops_count_ элементов
+    RequestType type_ = RequestType::UNKNOWN;
+    std::string name_;
+    double latitude_ = 0.0;
+    double longitude_ = 0.0;
+    bool is_roundtrip_ = false;
+    std::string_view unexpected_;  // Первое недопустимое значение запроса (пусто, если его нет)
+    std::vector<std::pair<std::string, int>> distances_;
+    size_t distances_count_ = 0;
+    std::vector<std::string> stop_names_;
+    size_t stops_count_ = 0;
+};
+
+// Загружает документ, заполняя каталог запросами раздела base_requests; раздел не превращается
+// в узлы и в документе остаётся пустым массивом. Если threads > 1 и входные данные достаточно
+// велики, массив запросов делится на части из целых элементов (json::SplitArraySection), части
+// разбираются на threads потоках в отдельные фрагменты, а остальной документ тем временем
+// разбирается в вызывающем потоке, который добавляет остановки готовых фрагментов по порядку.
+// Иначе раздел разбирается последовательно через CatalogueFiller
+json::Document LoadWithBaseRequests(std::shared_ptr<const json::InputBuffer> buffer, transport::Catalogue& catalogue,
+                                    size_t threads, std::unique_ptr<json::Arena> arena = nullptr);
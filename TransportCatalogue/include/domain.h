@@ -2,33 +2,33 @@
 
 #include "geo.h"
 
-#include <string>
-#include <vector>
-#include <set>
-#include <unordered_map>
+#include <cstdint>
+#include <string_view>
 
 namespace transport {
 
-// Остановка
+// Остановка. Координаты хранятся в массивах каталога (Catalogue::GetCoordinates)
 struct Stop {
-    std::string name;                     // Название остановки
-    geo::Coordinates coordinates;         // Координаты остановки
-    std::set<std::string> buses_by_stop;  // Набор номеров автобусов, проходящих через остановку
-};
-
-// Автобусный маршрут
-struct Bus {
-    std::string number;              // Номер маршрута
-    std::vector<const Stop*> stops;  // Список указателей на остановки маршрута
-    bool is_circle;                  // Является ли маршрут круговым
+    std::string_view name;                // Название остановки (хранится в NameArena каталога)
+    uint32_t id = 0;                      // Плотный идентификатор остановки (порядок добавления)
+    uint32_t buses_offset = 0;            // Начало списка автобусов остановки в общем массиве каталога
+    uint32_t buses_count = 0;             // Количество автобусов, проходящих через остановку
 };
 
 // Статистика по автобусному маршруту
 struct BusStat {
-    size_t stops_count;         // Общее количество остановок
-    size_t unique_stops_count;  // Количество уникальных остановок
-    double route_length;        // Длина маршрута
-    double curvature;           // Кривизна маршрута (отношение фактической длины к географической)
+    size_t stops_count = 0;         // Общее количество остановок
+    size_t unique_stops_count = 0;  // Количество уникальных остановок
+    double route_length = 0;        // Длина маршрута
+    double curvature = 0;           // Кривизна маршрута (отношение фактической длины к географической)
+};
+
+// Автобусный маршрут. Последовательность остановок и признак кольцевого маршрута
+// хранятся в массивах каталога (Catalogue::GetBusStops, Catalogue::IsRoundTrip)
+struct Bus {
+    std::string_view number;         // Номер маршрута (хранится в NameArena каталога)
+    uint32_t id = 0;                 // Плотный идентификатор маршрута (порядок добавления)
+    BusStat stat;                    // Статистика маршрута, вычисляется при заморозке каталога
 };
 
 } // namespace transport
@@ -1,6 +1,11 @@
 #pragma once
 
+#include "memory_usage.h"
+
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace geo {
 
@@ -23,4 +28,55 @@ struct Coordinates {
 // Функция для вычисления расстояния между двумя координатами
 double ComputeDistance(Coordinates from, Coordinates to);
 
-} // namespace geo
\ No newline at end of file
+// Единичный вектор точки на сфере
+struct SpherePoint {
+    double x;
+    double y;
+    double z;
+};
+
+// Вычисляет единичный вектор точки с заданными координатами
+SpherePoint ToSpherePoint(Coordinates coordinates);
+
+// Точки на единичной сфере, хранящиеся структурой массивов.
+// Для каждой точки один раз вычисляется единичный вектор (x, y, z), после чего
+// расстояние между точками считается без тригонометрии: по длине хорды c = |u1 - u2|
+// и центральному углу 2 * asin(c / 2)
+class SpherePoints {
+public:
+    // Добавляет точку и возвращает её индекс
+    uint32_t Add(Coordinates coordinates);
+
+    // Количество точек
+    size_t GetSize() const;
+
+    const double* GetX() const;
+    const double* GetY() const;
+    const double* GetZ() const;
+
+    // Занимаемая память
+    memory::Usage GetMemoryUsage() const;
+
+private:
+    std::vector<double> x_;
+    std::vector<double> y_;
+    std::vector<double> z_;
+};
+
+// Пакетно вычисляет расстояния (в метрах) между точками from[i] и to[i], записывая их в result[i].
+// Использует векторные инструкции (SSE2), когда они доступны, иначе скалярный код с тем же полиномом.
+// asin приближается рациональной функцией (Cephes); её относительная погрешность не превышает 4e-16
+// на [0, 1], а расстояние отличается от ComputeDistancesReference не более чем на 1e-8 м.
+void ComputeDistances(const SpherePoints& points, const uint32_t* from, const uint32_t* to, size_t count, double* result);
+
+// Пакетно вычисляет расстояния (в метрах) от точки from до точек to[i], записывая их в result[i].
+// Вычисление и погрешность те же, что у ComputeDistances
+void ComputeDistancesFrom(const SpherePoints& points, SpherePoint from, const uint32_t* to, size_t count, double* result);
+
+// Эталонная скалярная реализация ComputeDistances на std::asin, предназначенная для проверки
+void ComputeDistancesReference(const SpherePoints& points, const uint32_t* from, const uint32_t* to, size_t count, double* result);
+
+// Вычисляет длину ломаной, проходящей через точки path[0], path[1], ..., path[count - 1]
+double ComputePathLength(const SpherePoints& points, const uint32_t* path, size_t count);
+
+} // namespace geo
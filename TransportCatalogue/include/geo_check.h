@@ -0,0 +1,13 @@
+#pragma once
+
+#include <iostream>
+
+namespace geo {
+
+// Проверка пакетного вычисления расстояний: ComputeDistances и ComputeDistancesFrom сравниваются с ComputeDistancesReference
+// на случайных парах точек, на близких парах и на почти противоположных точках.
+// Для каждого набора выводится наибольшее отклонение в метрах; возвращает false,
+// если хотя бы одно отклонение превышает 1e-8 м
+bool RunDistanceCheck(std::ostream& output);
+
+} // namespace geo
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "memory_usage.h"
 #include "ranges.h"
 
 #include <cstdlib>
+#include <string_view>
 #include <vector>
 
 namespace graph {
@@ -12,7 +14,7 @@ using EdgeId = size_t;
 
 template <typename Weight>
 struct Edge {
-    std::string name;
+    std::string_view name;
     size_t quality;
     VertexId from;
     VertexId to;
@@ -34,6 +36,7 @@ public:
     size_t GetEdgeCount() const;
     const Edge<Weight>& GetEdge(EdgeId edge_id) const;
     IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+    memory::Usage GetMemoryUsage() const;
 
 private:
     std::vector<Edge<Weight>> edges_;
@@ -73,4 +76,15 @@ typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
     return ranges::AsRange(incidence_lists_.at(vertex));
 }
+
+template <typename Weight>
+memory::Usage DirectedWeightedGraph<Weight>::GetMemoryUsage() const {
+    memory::Usage usage{"DirectedWeightedGraph"};
+    usage.Add("edges", memory::VectorBytes(edges_));
+    usage.Add("incidence_lists", memory::VectorBytes(incidence_lists_));
+    for (const IncidenceList& list : incidence_lists_) {
+        usage.Add("incidence_lists", memory::VectorBytes(list));
+    }
+    return usage;
+}
 }  // namespace graph
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+// Неизменяемый буфер с входными данными разбора.
+// Файл по возможности отображается в память (POSIX mmap) и не копируется; если отображение
+// недоступно, содержимое считывается в память целиком. Буфер создаётся в shared_ptr, чтобы
+// документ, строки которого ссылаются на буфер, мог продлить его жизнь
+class InputBuffer {
+public:
+    // Отображает файл в память; при неудаче отображения считывает его.
+    // Если файл не удаётся открыть, выбрасывает std::runtime_error
+    static std::shared_ptr<const InputBuffer> MapFile(const std::string& path);
+
+    // Считывает поток целиком
+    static std::shared_ptr<const InputBuffer> ReadStream(std::istream& input);
+
+    // Забирает уже считанный текст без копирования
+    static std::shared_ptr<const InputBuffer> FromString(std::string text);
+
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+    ~InputBuffer();
+
+    std::string_view GetText() const;
+
+    // Отображён ли файл в память (иначе данные хранятся в динамической памяти)
+    bool IsMapped() const;
+
+    // Проверяет, указывает ли text внутрь буфера
+    bool Contains(std::string_view text) const;
+
+private:
+    InputBuffer() = default;
+
+    const char* data_ = nullptr;  // Начало данных: отображение или storage_
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::string storage_;         // Считанные данные, если файл не отображён
+};
+
+} // namespace json
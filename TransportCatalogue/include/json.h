@@ -1,24 +1,116 @@
 #pragma once
 
+#include "input_buffer.h"
+#include "json_arena.h"
+#include "memory_usage.h"
+
+#include <algorithm>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace json {
 
 class Node;
-using Dict = std::map<std::string, Node>;
-using Array = std::vector<Node>;
+class Handler;
+
+// Контейнеры документа используют полиморфный аллокатор: по умолчанию это обычная
+// динамическая память, а при загрузке в арену - блоки арены. Копия контейнера
+// всегда размещается в динамической памяти
+using Array = std::pmr::vector<Node>;
+
+// Словарь JSON: пары (ключ, значение) в одном непрерывном векторе, упорядоченные по ключу.
+// Интерфейс повторяет используемую часть std::map, обход идёт в порядке ключей.
+// В небольших словарях (а в каталоге у объектов 3-6 ключей) ключ ищется линейным просмотром,
+// в больших - двоичным поиском. Вставка сдвигает элементы, поэтому словарь из множества
+// ключей выгоднее строить конструктором из диапазона.
+// Ссылки и итераторы на элементы становятся недействительными после вставки
+class Dict {
+public:
+    using key_type = std::pmr::string;
+    using mapped_type = Node;
+    using value_type = std::pair<std::pmr::string, Node>;
+    using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+    using iterator = std::pmr::vector<value_type>::iterator;
+    using const_iterator = std::pmr::vector<value_type>::const_iterator;
+
+    Dict() = default;
+
+    explicit Dict(const allocator_type& allocator)
+        : items_(allocator) {
+    }
+
+    // Строит словарь из элементов в произвольном порядке; ключи должны быть различны.
+    // Элементы и ключи размещаются аллокатором словаря
+    template <typename InputIt>
+    Dict(InputIt first, InputIt last, const allocator_type& allocator = {})
+        : items_(first, last, allocator) {
+        std::sort(items_.begin(), items_.end(), KeyLess);
+    }
+
+    iterator begin() { return items_.begin(); }
+    iterator end() { return items_.end(); }
+    const_iterator begin() const { return items_.begin(); }
+    const_iterator end() const { return items_.end(); }
+
+    size_t size() const { return items_.size(); }
+    bool empty() const { return items_.empty(); }
+
+    // Ёмкость вектора элементов (для учёта памяти)
+    size_t capacity() const { return items_.capacity(); }
+
+    iterator find(std::string_view key);
+    const_iterator find(std::string_view key) const;
+    size_t count(std::string_view key) const;
+
+    // Значение по ключу; если ключа нет, выбрасывает std::out_of_range
+    Node& at(std::string_view key);
+    const Node& at(std::string_view key) const;
+
+    // Значение по ключу; если ключа нет, вставляет значение null
+    Node& operator[](std::string_view key);
+
+    // Вставляет пару, если ключа ещё нет; возвращает элемент с ключом и признак вставки
+    std::pair<iterator, bool> emplace(std::string_view key, Node value);
+
+    bool operator==(const Dict& rhs) const;
+
+private:
+    // Наибольший размер словаря, в котором ключ ищется линейно
+    static constexpr size_t LINEAR_SEARCH_LIMIT = 8;
+
+    static bool KeyLess(const value_type& lhs, const value_type& rhs);
+
+    // Позиция первого элемента с ключом не меньше key
+    size_t LowerBound(std::string_view key) const;
+
+    std::pmr::vector<value_type> items_;
+};
 
 class ParsingError : public std::runtime_error {
 public:
     using runtime_error::runtime_error;
 };
 
+// Строка, хранимая документом: без экранирования - прямо во входном буфере,
+// с экранированием - в арене документа
+struct BufferString {
+    std::string_view text;
+
+    bool operator==(const BufferString& other) const {
+        return text == other.text;
+    }
+};
+
 class Node final
-    : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string> {
+    : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string, BufferString> {
 public:
     using variant::variant;
 	using Value = variant;
@@ -85,11 +177,15 @@ public:
     }
 
     bool IsString() const {
-        return std::holds_alternative<std::string>(*this);
+        return std::holds_alternative<std::string>(*this) || std::holds_alternative<BufferString>(*this);
     }
         
-    const std::string& AsString() const {
+    // Строка действительна, пока жив узел (а для строк входного буфера - документ)
+    std::string_view AsString() const {
         using namespace std::literals;
+        if (const auto* buffer_string = std::get_if<BufferString>(this)) {
+            return buffer_string->text;
+        }
         if (!IsString()) {
             throw std::logic_error("Not a string"s);
         }
@@ -110,7 +206,11 @@ public:
         return std::get<Dict>(*this);
     }
 
+    // Строки сравниваются по содержимому независимо от способа хранения
     bool operator==(const Node& rhs) const {
+        if (IsString() && rhs.IsString()) {
+            return AsString() == rhs.AsString();
+        }
         return GetValue() == rhs.GetValue();
     }
 
@@ -127,18 +227,107 @@ inline bool operator!=(const Node& lhs, const Node& rhs) {
     return !(lhs == rhs);
 }
 
+inline bool Dict::KeyLess(const value_type& lhs, const value_type& rhs) {
+    return lhs.first < rhs.first;
+}
+
+inline size_t Dict::LowerBound(std::string_view key) const {
+    if (items_.size() <= LINEAR_SEARCH_LIMIT) {
+        size_t pos = 0;
+        while (pos < items_.size() && std::string_view(items_[pos].first) < key) {
+            ++pos;
+        }
+        return pos;
+    }
+    return std::lower_bound(items_.begin(), items_.end(), key, [](const value_type& item, std::string_view key) {
+        return std::string_view(item.first) < key;
+    }) - items_.begin();
+}
+
+inline Dict::iterator Dict::find(std::string_view key) {
+    const size_t pos = LowerBound(key);
+    return pos < items_.size() && items_[pos].first == key ? items_.begin() + pos : items_.end();
+}
+
+inline Dict::const_iterator Dict::find(std::string_view key) const {
+    const size_t pos = LowerBound(key);
+    return pos < items_.size() && items_[pos].first == key ? items_.begin() + pos : items_.end();
+}
+
+inline size_t Dict::count(std::string_view key) const {
+    return find(key) == end() ? 0 : 1;
+}
+
+inline Node& Dict::at(std::string_view key) {
+    const auto it = find(key);
+    if (it == end()) {
+        throw std::out_of_range("Dict::at: key not found");
+    }
+    return it->second;
+}
+
+inline const Node& Dict::at(std::string_view key) const {
+    const auto it = find(key);
+    if (it == end()) {
+        throw std::out_of_range("Dict::at: key not found");
+    }
+    return it->second;
+}
+
+inline Node& Dict::operator[](std::string_view key) {
+    return emplace(key, Node(nullptr)).first->second;
+}
+
+inline std::pair<Dict::iterator, bool> Dict::emplace(std::string_view key, Node value) {
+    const size_t pos = LowerBound(key);
+    if (pos < items_.size() && items_[pos].first == key) {
+        return {items_.begin() + pos, false};
+    }
+    return {items_.emplace(items_.begin() + pos, std::piecewise_construct,
+        std::forward_as_tuple(key), std::forward_as_tuple(std::move(value))), true};
+}
+
+inline bool Dict::operator==(const Dict& rhs) const {
+    return items_ == rhs.items_;
+}
+
 class Document {
 public:
     explicit Document(Node root)
         : root_(std::move(root)) {
     }
 
+    // Документ, строки которого могут ссылаться на buffer; буфер живёт не меньше документа
+    Document(Node root, std::shared_ptr<const InputBuffer> buffer)
+        : root_(std::move(root))
+        , buffer_(std::move(buffer)) {
+    }
+
     const Node& GetRoot() const {
-        return root_;
+        return arena_root_ != nullptr ? *arena_root_ : root_;
     }
 
+    // Занимаемая память с разбивкой по видам узлов
+    memory::Usage GetMemoryUsage() const;
+
 private:
-    Node root_;
+    friend Document LoadFromBuffer(std::shared_ptr<const InputBuffer> buffer, std::unique_ptr<Arena> arena);
+    friend Document LoadFromBuffer(std::shared_ptr<const InputBuffer> buffer, std::string_view section,
+                                   Handler& section_handler, std::unique_ptr<Arena> arena);
+
+    // Документ, все узлы которого размещены в arena; root создан в ней же
+    Document(const Node* root, std::unique_ptr<Arena> arena, std::shared_ptr<const InputBuffer> buffer)
+        : buffer_(std::move(buffer))
+        , arena_(std::move(arena))
+        , arena_root_(root) {
+    }
+
+    Node root_;                                  // Корень документа в динамической памяти
+    std::shared_ptr<const InputBuffer> buffer_;  // Входной буфер, на который ссылаются строки
+    std::unique_ptr<Arena> arena_;               // Арена узлов документа, если он загружен в неё
+    // Корень документа в арене. Деструкторы узлов арены не вызываются:
+    // вся их память освобождается вместе с ареной
+    const Node* arena_root_ = nullptr;
 };
 
 inline bool operator==(const Document& lhs, const Document& rhs) {
@@ -149,7 +338,19 @@ inline bool operator!=(const Document& lhs, const Document& rhs) {
     return !(lhs == rhs);
 }
 
-Document Load(std::istream& input);
+// Если передана арена, все узлы, контейнеры и строки документа размещаются в ней;
+// документ владеет ареной и при уничтожении освобождает её целиком, не обходя узлы
+Document Load(std::istream& input, std::unique_ptr<Arena> arena = nullptr);
+
+// Разбирает документ из буфера без копирования: строки без экранирования указывают в буфер,
+// копируются только строки с экранированием. Документ удерживает буфер
+Document LoadFromBuffer(std::shared_ptr<const InputBuffer> buffer, std::unique_ptr<Arena> arena = nullptr);
+
+// Разбирает документ так же, но значение ключа section верхнего словаря не превращается в узлы:
+// события его разбора передаются section_handler, а в документе этого ключа нет.
+// Так большой раздел можно обработать за тот же проход, не строя для него дерево
+Document LoadFromBuffer(std::shared_ptr<const InputBuffer> buffer, std::string_view section,
+                        Handler& section_handler, std::unique_ptr<Arena> arena = nullptr);
 
 void Print(const Document& doc, std::ostream& output);
 
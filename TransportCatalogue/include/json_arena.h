@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace json {
+
+// Арена для узлов документа: память выделяется последовательно из крупных блоков
+// (std::pmr::monotonic_buffer_resource) и не возвращается по отдельности.
+// Все блоки освобождаются разом при уничтожении арены, поэтому документу в арене
+// не нужно обходить дерево узлов и вызывать их деструкторы
+class Arena final : public std::pmr::memory_resource {
+public:
+    // initial_block_size - размер первого блока; следующие блоки растут в геометрической прогрессии
+    explicit Arena(size_t initial_block_size = DEFAULT_BLOCK_SIZE);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Объём блоков, полученных ареной
+    size_t GetReservedBytes() const;
+
+private:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    // Источник блоков арены, подсчитывающий выделенную память
+    class BlockSource final : public std::pmr::memory_resource {
+    public:
+        size_t GetBytes() const;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        size_t bytes_ = 0;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    BlockSource blocks_;
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+} // namespace json
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace json {
+
+// Замер скорости разбора JSON-файлов. Первым разбирается синтетический вход, состоящий
+// в основном из координат и расстояний, затем перечисленные файлы. Каждый вход разбирается
+// несколько раз: только первым и вторым этапом с пустым обработчиком (SAX), с построением
+// документа в динамической памяти (DOM) и в арене (DOM arena). Время DOM включает
+// уничтожение документа. Для каждого режима выводится лучшее время и пропускная способность в МБ/с
+void RunParseBenchmark(const std::vector<std::string>& paths, std::ostream& output);
+
+} // namespace json
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "json.h"
+
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Обработчик событий потокового (SAX) разбора JSON.
+// Строки и ключи передаются как string_view, действительные только на время вызова:
+// обработчик, которому они нужны позже, копирует их сам
+class Handler {
+public:
+    virtual ~Handler() = default;
+
+    virtual void StartObject() = 0;
+    virtual void Key(std::string_view key) = 0;
+    virtual void EndObject() = 0;
+
+    virtual void StartArray() = 0;
+    virtual void EndArray() = 0;
+
+    virtual void String(std::string_view value) = 0;
+    virtual void Int(int value) = 0;
+    virtual void Double(double value) = 0;
+    virtual void Bool(bool value) = 0;
+    virtual void Null() = 0;
+};
+
+// Разбирает JSON-значение из буфера, сообщая обработчику о каждом элементе по порядку.
+// Вложенность обрабатывается без рекурсии. Символы после значения игнорируются.
+// При ошибке разбора выбрасывает ParsingError
+void Parse(std::string_view text, Handler& handler);
+
+// Считывает поток целиком в буфер и разбирает его
+void Parse(std::istream& input, Handler& handler);
+
+// Разбирает элементы массива без окружающих скобок: text - часть текста массива из целых
+// элементов, разделённых запятыми. Обработчик получает события элементов, но не StartArray и EndArray
+void ParseArrayItems(std::string_view text, Handler& handler);
+
+// Массив - значение ключа верхнего словаря, поделённый на части из целых элементов
+struct ArraySection {
+    size_t begin = 0;                       // Позиция '[' в тексте
+    size_t end = 0;                         // Позиция сразу за ']'
+    std::vector<std::string_view> parts;    // Тексты частей по порядку для ParseArrayItems
+};
+
+// Находит массив - значение ключа key верхнего словаря - и делит его не более чем на parts частей
+// из целых элементов. Возвращает nullopt, если такого ключа нет или его значение не массив
+// (ключ с экранированием не распознаётся). Текст от начала массива делится на parts участков,
+// которые сводятся на threads потоках (json::SummarizeRange); затем короткий последовательный
+// проход по сводкам находит в каждом участке первую запятую между элементами и конец массива.
+// Проверяется только вложенность скобок: остальное проверяется при разборе частей
+std::optional<ArraySection> SplitArraySection(std::string_view text, std::string_view key, size_t parts, size_t threads);
+
+} // namespace json
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "json_writer.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Построитель JSON с тем же цепочечным интерфейсом, что и Builder, который не создаёт
+// узлов, а сразу выводит элементы в буфер. Правила контекстов совпадают с Builder.
+// Ключи словаря выводятся в порядке вызовов, поэтому их нужно задавать по возрастанию,
+// как они упорядочены в Dict: тогда вывод совпадает с выводом построенного узла.
+// Ключ не больше предыдущего в том же словаре - ошибка (std::logic_error).
+// Стек открытых контейнеров и ключи переиспользуются, поэтому построитель, выводящий
+// много ответов, после первых из них не выделяет память
+class StreamBuilder {
+public:
+    class DictItemContext;
+    class ArrayItemContext;
+    class KeyValueContext;
+
+    explicit StreamBuilder(OutputBuffer& output, const PrintOptions& options = {});
+
+    // Проверяет, что значение верхнего уровня выведено полностью
+    void Finish() const;
+
+    // Начинает следующее значение верхнего уровня в том же буфере (например, очередную
+    // строку NDJSON). Текущее значение должно быть выведено полностью
+    void Reset();
+
+    // Отказывается от незавершённого значения верхнего уровня: открытые контейнеры забываются,
+    // и построитель снова ожидает новое значение. Уже выведенная часть остаётся в буфере
+    void Discard();
+
+    KeyValueContext Key(std::string_view key);
+    DictItemContext StartDict();
+    ArrayItemContext StartArray();
+    StreamBuilder& EndDict();
+    StreamBuilder& EndArray();
+
+    template <typename T>
+    StreamBuilder& Value(const T& value) {
+        BeginValue();
+        WriteValue(value);
+        return *this;
+    }
+
+private:
+    // Открытый массив или словарь
+    struct Level {
+        bool is_dict = false;
+        bool first = true;          // Ещё нет ни одного элемента
+        bool has_key = false;       // Словарь ожидает значение для выведенного ключа
+        std::string last_key;       // Последний ключ словаря
+        int indent = 0;             // Отступ строки, на которой начинается контейнер
+    };
+
+    // Проверяет, что значение допустимо в текущем контексте, и выводит разделитель;
+    // возвращает отступ, с которого начинается значение
+    int BeginValue();
+    void PushLevel(bool is_dict, int indent);
+
+    void WriteValue(int value) { formatter_.WriteInt(value); }
+    void WriteValue(double value) { formatter_.WriteDouble(value); }
+    void WriteValue(bool value) { formatter_.WriteBool(value); }
+    void WriteValue(std::nullptr_t) { formatter_.WriteNull(); }
+    void WriteValue(std::string_view value) { formatter_.WriteString(value); }
+    void WriteValue(const char* value) { formatter_.WriteString(value); }
+    void WriteValue(const std::string& value) { formatter_.WriteString(value); }
+    void WriteValue(const Node& value) { formatter_.WriteNode(value, value_indent_); }
+
+    Formatter formatter_;
+    std::vector<Level> levels_;   // Открытые контейнеры; используются первые depth_
+    size_t depth_ = 0;
+    bool root_done_ = false;      // Значение верхнего уровня начато
+    int value_indent_ = 0;        // Отступ строки текущего значения
+};
+
+class StreamBuilder::DictItemContext {
+public:
+    DictItemContext(StreamBuilder& builder)
+        : builder_(builder) {}
+
+    KeyValueContext Key(std::string_view key);
+    StreamBuilder& EndDict();
+
+private:
+    StreamBuilder& builder_;
+};
+
+class StreamBuilder::ArrayItemContext {
+public:
+    ArrayItemContext(StreamBuilder& builder)
+        : builder_(builder) {}
+
+    template <typename T>
+    ArrayItemContext Value(const T& value) {
+        builder_.Value(value);
+        return *this;
+    }
+
+    DictItemContext StartDict();
+    ArrayItemContext StartArray();
+    StreamBuilder& EndArray();
+
+private:
+    StreamBuilder& builder_;
+};
+
+class StreamBuilder::KeyValueContext {
+public:
+    KeyValueContext(StreamBuilder& builder)
+        : builder_(builder) {}
+
+    template <typename T>
+    DictItemContext Value(const T& value) {
+        builder_.Value(value);
+        return DictItemContext(builder_);
+    }
+
+    DictItemContext StartDict();
+    ArrayItemContext StartArray();
+
+private:
+    StreamBuilder& builder_;
+};
+
+} // namespace json
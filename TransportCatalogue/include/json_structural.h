@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Первый этап разбора JSON: векторный просмотр буфера блоками по 64 байта.
+// Для каждого блока строятся битовые маски кавычек, обратных косых черт, пробельных
+// и структурных символов ({ } [ ] : ,). По ним вычисляются экранированные символы,
+// области строк (префиксным XOR масок кавычек) и позиции элементов: структурные символы
+// вне строк, неэкранированные кавычки и начала чисел и литералов после пробелов или
+// структурных символов. Второй этап переходит между этими позициями, не просматривая
+// пробелы и содержимое строк побайтно.
+// Маски хранятся по одному слову на 64 байта, а буфер просматривается частями по мере
+// продвижения разбора, поэтому дополнительная память не зависит от размера входных данных. Запросы должны идти по неубыванию позиции.
+class StructuralScanner {
+public:
+    explicit StructuralScanner(std::string_view text);
+
+    // Позиция первого элемента не раньше pos; размер буфера, если таких нет.
+    // Пробелы вне строк между pos и найденной позицией гарантированно пропущены
+    size_t NextToken(size_t pos) {
+        // Быстрый путь: элемент в том же, уже просмотренном блоке
+        const size_t index = pos / 64 - first_block_;
+        if (index < token_masks_.size()) {
+            const uint64_t mask = token_masks_[index] & (~uint64_t{0} << (pos % 64));
+            if (mask != 0) {
+                return pos - pos % 64 + __builtin_ctzll(mask);
+            }
+        }
+        return FindNextToken(pos);
+    }
+
+    // Есть ли в [begin, end) внутри строки символ '\\', '\n' или '\r'.
+    // end не должен превышать позицию, уже возвращённую NextToken
+    bool HasStringSpecial(size_t begin, size_t end) const {
+        if (begin / 64 == end / 64) {
+            const uint64_t range = (~uint64_t{0} << (begin % 64)) & ((uint64_t{1} << (end % 64)) - 1);
+            return (special_masks_[begin / 64 - first_block_] & range) != 0;
+        }
+        return HasSpecialInBlocks(begin, end);
+    }
+
+private:
+    size_t FindNextToken(size_t pos);
+    bool HasSpecialInBlocks(size_t begin, size_t end) const;
+
+    // Просматривает следующую часть буфера, отбрасывая позиции до pos
+    void ScanChunk(size_t pos);
+
+    std::string_view text_;
+    size_t scanned_ = 0;                 // Граница просмотренной части буфера
+
+    // Маски просмотренных блоков начиная с блока first_block_: позиции элементов
+    // и особых символов внутри строк. Бит i маски блока b соответствует позиции 64 * b + i
+    size_t first_block_ = 0;
+    std::vector<uint64_t> token_masks_;
+    std::vector<uint64_t> special_masks_;
+
+    // Состояние на границе блоков
+    uint64_t next_is_escaped_ = 0;       // Первый символ следующего блока экранирован
+    uint64_t in_string_ = 0;             // Все единицы, если блок закончился внутри строки
+    uint64_t follows_separator_ = 1;     // Последний символ блока - пробел или структурный символ
+};
+
+// Сводка участка текста для параллельного поиска границ элементов массива: участки сводятся
+// независимо, а состояние в начале каждого затем получается последовательным проходом по сводкам.
+// Неизвестно, начинается ли участок внутри строки, поэтому вложенность скобок вне строк
+// считается для обоих случаев: индекс 0 - участок начинается вне строки, 1 - внутри
+struct RangeSummary {
+    bool odd_quotes = false;         // Нечётное количество неэкранированных кавычек
+    int depth_change[2] = {0, 0};    // Вложенность в конце участка относительно начала
+    int min_depth[2] = {0, 0};       // Наименьшая вложенность внутри участка относительно начала
+};
+
+// Сводит участок text. Он не должен начинаться с экранированного символа
+RangeSummary SummarizeRange(std::string_view text);
+
+// Первая позиция вне строк, где вложенность относительно начала text равна depth и стоит запятая
+// (если commas) или закрывающая скобка; размер text, если такой нет. in_string - начинается ли
+// text внутри строки. Как и для SummarizeRange, text не должен начинаться с экранированного символа
+size_t FindAtDepth(std::string_view text, bool in_string, int depth, bool commas);
+
+} // namespace json
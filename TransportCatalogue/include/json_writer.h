@@ -0,0 +1,126 @@
+#pragma once
+
+#include "json.h"
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+// Буфер вывода: данные накапливаются в памяти и передаются приёмнику (файловому
+// дескриптору или потоку) крупными порциями. Буфер сбрасывается при заполнении,
+// при вызове Flush и при уничтожении
+class OutputBuffer {
+public:
+    // Дескриптор стандартного вывода
+    static constexpr int STDOUT_FD = 1;
+
+    explicit OutputBuffer(std::ostream& output);
+
+    // Вывод напрямую в файловый дескриптор, минуя потоки и stdio
+    explicit OutputBuffer(int fd);
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    // Сбрасывает остаток буфера; ошибки вывода при этом игнорируются
+    ~OutputBuffer();
+
+    void Write(std::string_view text) {
+        data_.append(text);
+        FlushIfFull();
+    }
+
+    void Put(char c) {
+        data_.push_back(c);
+        FlushIfFull();
+    }
+
+    // Выводит count символов c
+    void Fill(char c, size_t count) {
+        data_.append(count, c);
+        FlushIfFull();
+    }
+
+    // Передаёт накопленные данные приёмнику. При ошибке записи выбрасывает std::runtime_error
+    void Flush();
+
+    // Количество символов, выведенных с начала работы (включая ещё не переданные приёмнику)
+    size_t GetPosition() const {
+        return flushed_ + data_.size();
+    }
+
+    // Отбрасывает символы, выведенные после позиции position. Возвращает false и ничего
+    // не меняет, если часть из них уже передана приёмнику
+    bool Truncate(size_t position);
+
+private:
+    // Размер порции, при накоплении которой буфер сбрасывается
+    static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+    void FlushIfFull() {
+        if (data_.size() >= FLUSH_SIZE) {
+            Flush();
+        }
+    }
+
+    std::ostream* stream_ = nullptr;  // Приёмник-поток или nullptr
+    int fd_ = -1;                     // Приёмник-дескриптор, если stream_ не задан
+    std::string data_;
+    size_t flushed_ = 0;              // Сколько символов уже передано приёмнику
+};
+
+// Параметры вывода JSON
+struct PrintOptions {
+    // С отступами и переносами строк (как Print) или в одну строку без пробелов
+    bool pretty = true;
+    // Шаг отступа в режиме с отступами
+    int indent_step = 4;
+    // Вещественные числа: кратчайшая запись, точно восстанавливающая значение,
+    // или 6 значащих цифр, как при выводе в std::ostream по умолчанию
+    bool shortest_doubles = false;
+};
+
+// Вывод отдельных элементов JSON в буфер: значений, ключей, скобок, разделителей и отступов.
+// Строки экранируются по таблице символов: участки без особых символов копируются целиком.
+// Числа форматируются std::to_chars.
+// Контейнер выводится так: OpenContainer, для каждого элемента BeginItem и значение
+// (для словаря перед значением WriteKey), затем EndContainer. Отступ indent - отступ строки,
+// на которой начинается контейнер; элементы выводятся с отступом GetInnerIndent(indent)
+class Formatter {
+public:
+    Formatter(OutputBuffer& output, const PrintOptions& options)
+        : output_(output)
+        , options_(options) {
+    }
+
+    void OpenContainer(char bracket);
+    void BeginItem(bool first, int indent);
+    void EndContainer(char bracket, int indent);
+
+    int GetInnerIndent(int indent) const {
+        return indent + options_.indent_step;
+    }
+
+    // Ключ словаря с двоеточием
+    void WriteKey(std::string_view key);
+
+    void WriteString(std::string_view text);
+    void WriteInt(int value);
+    void WriteDouble(double value);
+    void WriteBool(bool value);
+    void WriteNull();
+
+    // Узел целиком, начиная со строки с отступом indent
+    void WriteNode(const Node& node, int indent);
+
+private:
+    OutputBuffer& output_;
+    PrintOptions options_;
+};
+
+// Выводит узел в буфер
+void WriteNode(const Node& node, OutputBuffer& output, const PrintOptions& options = {});
+
+} // namespace json
@@ -4,6 +4,7 @@
 #include "geo.h"
 #include "json.h"
 #include "domain.h"
+#include "transport_catalogue.h"
 
 #include <algorithm>
 #include <optional>
@@ -112,20 +113,20 @@ public:
         : render_settings_(render_settings) {}
 
     // Функции для получения элементов SVG
-    std::vector<svg::Polyline> GetRouteLines(const std::map<std::string_view, const transport::Bus*>& buses, const SphereProjector& sp) const;
-    std::vector<svg::Text> GetBusLabels(const std::map<std::string_view, const transport::Bus*>& buses, const SphereProjector& sp) const;
-    std::vector<svg::Circle> GetStopSymbols(const std::map<std::string_view, const transport::Stop*>& stops, const SphereProjector& sp) const;
-    std::vector<svg::Text> GetStopLabels(const std::map<std::string_view, const transport::Stop*>& stops, const SphereProjector& sp) const;
+    std::vector<svg::Polyline> GetRouteLines(const transport::Catalogue& catalogue, const SphereProjector& sp) const;
+    std::vector<svg::Text> GetBusLabels(const transport::Catalogue& catalogue, const SphereProjector& sp) const;
+    std::vector<svg::Circle> GetStopSymbols(const transport::Catalogue& catalogue, const std::vector<const transport::Stop*>& stops, const SphereProjector& sp) const;
+    std::vector<svg::Text> GetStopLabels(const transport::Catalogue& catalogue, const std::vector<const transport::Stop*>& stops, const SphereProjector& sp) const;
 
-    // Функция для получения SVG-документа с картой
-    svg::Document GetSVG(const std::map<std::string_view, const transport::Bus*>& buses) const;
+    // Функция для получения SVG-документа с картой замороженного каталога
+    svg::Document GetSVG(const transport::Catalogue& catalogue) const;
 
 private:
     // Вспомогательные функции для добавления элементов в SVG-документ
-    void AddRouteLinesToSVG(svg::Document& doc, const std::map<std::string_view, const transport::Bus*>& buses, const SphereProjector& sp) const;
-    void AddBusLabelsToSVG(svg::Document& doc, const std::map<std::string_view, const transport::Bus*>& buses, const SphereProjector& sp) const;
-    void AddStopSymbolsToSVG(svg::Document& doc, const std::map<std::string_view, const transport::Stop*>& stops, const SphereProjector& sp) const;
-    void AddStopLabelsToSVG(svg::Document& doc, const std::map<std::string_view, const transport::Stop*>& stops, const SphereProjector& sp) const;
+    void AddRouteLinesToSVG(svg::Document& doc, const transport::Catalogue& catalogue, const SphereProjector& sp) const;
+    void AddBusLabelsToSVG(svg::Document& doc, const transport::Catalogue& catalogue, const SphereProjector& sp) const;
+    void AddStopSymbolsToSVG(svg::Document& doc, const transport::Catalogue& catalogue, const std::vector<const transport::Stop*>& stops, const SphereProjector& sp) const;
+    void AddStopLabelsToSVG(svg::Document& doc, const transport::Catalogue& catalogue, const std::vector<const transport::Stop*>& stops, const SphereProjector& sp) const;
 
     const RenderSettings render_settings_;  // Настройки рендеринга
 };
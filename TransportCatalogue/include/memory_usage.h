@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace memory {
+
+// Занимаемая структурой память с разбивкой по внутренним контейнерам.
+// Учитывается динамическая память (по ёмкости контейнеров), а не размер самих объектов
+struct Usage {
+    std::string name;         // Название структуры или контейнера
+    size_t bytes = 0;         // Общий объём, включая все составляющие
+    std::vector<Usage> parts; // Составляющие
+
+    Usage() = default;
+    explicit Usage(std::string usage_name)
+        : name(std::move(usage_name)) {}
+
+    // Добавляет bytes к составляющей part_name (создаёт её при первом обращении)
+    Usage& Add(std::string_view part_name, size_t part_bytes);
+
+    // Добавляет вложенный отчёт как составляющую
+    Usage& Add(Usage part);
+};
+
+// Память под элементы вектора (для аллокатора арены - занятая в арене)
+template <typename T, typename Allocator>
+size_t VectorBytes(const std::vector<T, Allocator>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+// Память под элементы дека (без учёта неполных блоков и карты блоков)
+template <typename T>
+size_t DequeBytes(const std::deque<T>& values) {
+    return values.size() * sizeof(T);
+}
+
+// Динамическая память строки; короткие строки хранятся внутри объекта и не занимают её
+template <typename Allocator>
+size_t StringBytes(const std::basic_string<char, std::char_traits<char>, Allocator>& value) {
+    // Строка без динамической памяти хранит символы внутри самого объекта
+    const auto data = reinterpret_cast<std::uintptr_t>(value.data());
+    const auto object = reinterpret_cast<std::uintptr_t>(&value);
+    if (data >= object && data < object + sizeof(value)) {
+        return 0;
+    }
+    return value.capacity() + 1;
+}
+
+// Выводит отчёт деревом с отступами
+void Print(const Usage& usage, std::ostream& output);
+
+} // namespace memory
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "memory_usage.h"
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace transport {
+
+// Идентификатор интернированного имени
+using NameId = uint32_t;
+
+// Хранилище интернированных имён остановок и маршрутов.
+// Каждое имя хранится один раз; символы складываются подряд в крупные блоки,
+// которые никогда не перемещаются, поэтому и идентификатор, и string_view на имя
+// остаются действительными всё время жизни хранилища.
+// Поиск имени выполняется по единой хеш-таблице с открытой адресацией.
+class NameArena {
+public:
+    // Значение, обозначающее отсутствие имени
+    static constexpr NameId NO_NAME = UINT32_MAX;
+
+    // Возвращает идентификатор имени, добавляя его при первом обращении
+    NameId Intern(std::string_view name);
+
+    // Возвращает идентификатор имени или NO_NAME, если имя не встречалось
+    NameId Find(std::string_view name) const;
+
+    // Возвращает имя по идентификатору
+    std::string_view GetName(NameId id) const;
+
+    // Количество различных имён
+    size_t GetSize() const;
+
+    // Занимаемая память
+    memory::Usage GetMemoryUsage() const;
+
+private:
+    // Размер блока для хранения символов имён
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    // Копирует символы имени в блоки и возвращает устойчивое представление
+    std::string_view Store(std::string_view name);
+
+    // Возвращает индекс ячейки с именем либо первой свободной ячейки на пути пробирования
+    size_t FindSlot(std::string_view name, size_t hash) const;
+
+    // Увеличивает таблицу и перераспределяет идентификаторы
+    void Rehash(size_t capacity);
+
+    std::vector<std::unique_ptr<char[]>> blocks_;  // Блоки с символами имён
+    size_t block_used_ = BLOCK_SIZE;               // Заполненность последнего блока
+    size_t blocks_bytes_ = 0;                      // Суммарный размер блоков
+
+    std::vector<std::string_view> names_;  // Имена по идентификаторам
+    std::vector<size_t> hashes_;           // Хеши имён по идентификаторам
+    std::vector<NameId> slots_;            // Таблица открытой адресации (линейное пробирование)
+};
+
+} // namespace transport
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "memory_usage.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace transport {
+
+// Найденное имя: позиция в упорядоченном списке имён и расстояние редактирования
+using NameMatch = std::pair<uint32_t, int>;
+
+// Индекс для поиска по началу имени с допуском опечаток.
+// Имена хранятся упорядоченными, в виде кодовых точек Unicode, подряд в одном массиве;
+// для каждого имени запоминается длина общего префикса с предыдущим. Благодаря этому
+// упорядоченный массив работает как неявное префиксное дерево: строки таблицы
+// расстояния Левенштейна для общего префикса соседних имён не пересчитываются,
+// а диапазон имён с префиксом, после которого расстояние уже не может измениться,
+// пропускается целиком.
+class NameSearchIndex {
+public:
+    // Наибольшее поддерживаемое расстояние редактирования
+    static constexpr int MAX_DISTANCE = 2;
+
+    NameSearchIndex() = default;
+
+    // Строит индекс по именам, упорядоченным по возрастанию и не содержащим повторов
+    explicit NameSearchIndex(const std::vector<std::string_view>& sorted_names);
+
+    // Возвращает не более limit имён, начало которых отличается от query не более чем на
+    // max_distance правок (вставка, удаление или замена символа). Результат упорядочен по
+    // расстоянию, при равенстве - по имени. При max_distance == 0 это поиск по префиксу
+    std::vector<NameMatch> Find(std::string_view query, size_t limit, int max_distance) const;
+
+    // Занимаемая память
+    memory::Usage GetMemoryUsage() const;
+
+private:
+    // Поиск по точному префиксу: имена с префиксом образуют непрерывный диапазон
+    std::vector<NameMatch> FindPrefix(const std::u32string& query, size_t limit) const;
+
+    // Поиск по префиксу с опечатками обходом имён с общими строками таблицы расстояний
+    std::vector<NameMatch> FindFuzzy(const std::u32string& query, size_t limit, int max_distance) const;
+
+    // Возвращает позицию первого имени после position, не начинающегося с первых depth символов имени position
+    uint32_t GetSubtreeEnd(uint32_t position, uint32_t depth) const;
+
+    // Длина имени в символах
+    uint32_t GetLength(uint32_t position) const;
+
+    std::vector<char32_t> chars_;    // Символы всех имён подряд
+    std::vector<uint32_t> offsets_;  // Начала имён в chars_ (размер - число имён + 1)
+    std::vector<uint32_t> lcp_;      // Длина общего префикса с предыдущим именем
+    uint32_t max_length_ = 0;        // Длина самого длинного имени (высота таблицы расстояний)
+};
+
+} // namespace transport
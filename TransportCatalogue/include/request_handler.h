@@ -4,22 +4,29 @@
 #include "transport_catalogue.h"
 #include "map_renderer.h"
 #include "transport_router.h"
+#include "snapshot.h"
 
-#include <sstream>
+#include <memory>
+#include <optional>
+#include <string>
 
 class RequestHandler {
 public:
-    // Инициализирует обработчик запросов с помощью каталога транспорта и рендерера карты
-    RequestHandler(const transport::Catalogue& catalogue, const renderer::MapRenderer& renderer, const transport::Router& router)
-        : catalogue_(catalogue)  
-        , renderer_(renderer) 
-        , router_(router) {} 
+    // Инициализирует обработчик запросов версией данных; версия удерживается, пока жив обработчик,
+    // поэтому запросы дорабатывают на ней даже после публикации новой версии.
+    // Маршрутизатор и карта версии строятся при первом запросе, которому они нужны
+    explicit RequestHandler(std::shared_ptr<const transport::Snapshot> snapshot)
+        : snapshot_(std::move(snapshot))
+        , catalogue_(snapshot_->GetCatalogue()) {}
 
     // Метод для получения статистики о маршруте по номеру автобуса
     std::optional<transport::BusStat> GetBusStat(const std::string_view bus_number) const;
 
-    // Метод для получения набора номеров автобусов, проходящих через указанную остановку
-    const std::set<std::string> GetBusesByStop(std::string_view stop_name) const;
+    // Метод для получения идентификаторов автобусов, проходящих через указанную остановку (по возрастанию номера)
+    transport::Catalogue::BusIdRange GetBusesByStop(std::string_view stop_name) const;
+
+    // Метод для получения номера автобуса по его идентификатору
+    std::string_view GetBusNumber(uint32_t bus_id) const;
 
     // Метод для проверки, существует ли автобус с указанным номером
     bool IsBusNumber(const std::string_view bus_number) const;
@@ -30,14 +37,23 @@ public:
     // Метод для получения оптимального маршрута между двумя остановками
     const std::optional<graph::Router<double>::RouteInfo> GetOptimalRoute(const std::string_view stop_from, const std::string_view stop_to) const;
    
+    // Метод для поиска остановок рядом с точкой: в радиусе radius метров и/или не более count ближайших
+    std::vector<transport::Catalogue::NearbyStop> GetNearbyStops(geo::Coordinates center, std::optional<double> radius, std::optional<size_t> count) const;
+
+    // Методы для поиска остановок и маршрутов по началу имени с допуском max_distance опечаток
+    std::vector<transport::Catalogue::StopMatch> SearchStops(std::string_view query, size_t limit, int max_distance) const;
+    std::vector<transport::Catalogue::BusMatch> SearchBuses(std::string_view query, size_t limit, int max_distance) const;
+
     // Метод для получения графа маршрутизатора
     const graph::DirectedWeightedGraph<double>& GetRouterGraph() const;
 
-    // Метод для рендеринга карты и получения SVG-документа
-    svg::Document RenderMap() const;
+    // Метод для проверки, является ли ребро графа пешим переходом
+    bool IsWalkEdge(graph::EdgeId edge_id) const;
+
+    // Метод для получения SVG-текста карты; карта версии данных отрисовывается один раз
+    const std::string& GetMapSvg() const;
 
 private:
-    const transport::Catalogue& catalogue_;  // Ссылка на объект каталога транспорта
-    const renderer::MapRenderer& renderer_;  // Ссылка на объект рендерера карты
-    const transport::Router& router_;        // Ссылка на объект маршрутизатора
+    std::shared_ptr<const transport::Snapshot> snapshot_;  // Удерживаемая версия данных
+    const transport::Catalogue& catalogue_;                // Каталог версии данных
 };
\ No newline at end of file
@@ -29,6 +29,8 @@ public:
 
     std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
 
+    memory::Usage GetMemoryUsage() const;
+
 private:
     struct RouteInternalData {
         Weight weight;
@@ -114,4 +116,14 @@ std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(Ver
     return RouteInfo{weight, std::move(edges)};
 }
 
+template <typename Weight>
+memory::Usage Router<Weight>::GetMemoryUsage() const {
+    memory::Usage usage{"Router"};
+    usage.Add("routes_internal_data", memory::VectorBytes(routes_internal_data_));
+    for (const auto& row : routes_internal_data_) {
+        usage.Add("routes_internal_data", memory::VectorBytes(row));
+    }
+    return usage;
+}
+
 }  // namespace graph
\ No newline at end of file
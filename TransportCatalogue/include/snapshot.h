@@ -0,0 +1,96 @@
+#pragma once
+
+#include "transport_catalogue.h"
+#include "map_renderer.h"
+#include "transport_router.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace transport {
+
+// Неизменяемая версия данных: замороженный каталог, рендерер карты и маршрутизатор.
+// Маршрутизатор и карта строятся при первом обращении к ним: если к версии не приходят
+// запросы Route и Map, на их построение время не тратится.
+// Создаётся через std::make_shared и публикуется в SnapshotHolder
+class Snapshot : public std::enable_shared_from_this<Snapshot> {
+public:
+    // Принимает заполненный каталог и замораживает его на threads потоках; routing_settings -
+    // маршрутизатор с настройками, граф которого ещё не построен
+    Snapshot(Catalogue catalogue, const renderer::MapRenderer& renderer, Router routing_settings, uint64_t version,
+             size_t threads = 1);
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    const Catalogue& GetCatalogue() const;
+    const renderer::MapRenderer& GetRenderer() const;
+
+    // Маршрутизатор; при первом обращении строит его граф. Может вызываться из разных потоков
+    const Router& GetRouter() const;
+
+    // Построен ли уже маршрутизатор
+    bool IsRouterBuilt() const;
+
+    // SVG-текст карты; при первом обращении отрисовывает её. Может вызываться из разных потоков
+    const std::string& GetMapSvg() const;
+
+    // Отрисована ли уже карта
+    bool IsMapRendered() const;
+
+    // Память отрисовки карты: SVG-документ (освобождается после вывода в текст) и сохранённый
+    // текст. Доступно после отрисовки
+    const memory::Usage& GetMapMemoryUsage() const;
+
+    // Номер версии данных
+    uint64_t GetVersion() const;
+
+private:
+    Catalogue catalogue_;              // Каталог; объявлен первым, так как маршрутизатор строится по нему
+    renderer::MapRenderer renderer_;   // Рендерер карты
+    uint64_t version_;                 // Номер версии
+
+    mutable Router router_;                        // Маршрутизатор по графу каталога
+    mutable std::once_flag router_once_;           // Построение графа маршрутизатора
+    mutable std::atomic<bool> router_built_{false};
+    mutable std::string map_svg_;                  // Отрисованная карта
+    mutable memory::Usage map_usage_;              // Память отрисовки карты
+    mutable std::once_flag map_once_;              // Отрисовка карты
+    mutable std::atomic<bool> map_rendered_{false};
+};
+
+// Точка публикации текущей версии данных (в стиле RCU).
+// Читатели получают shared_ptr на текущую версию без блокировок: только атомарные операции.
+// Публикация новой версии не прерывает обработку запросов на старой: старая версия
+// освобождается, когда завершится последний запрос, который её удерживает
+class SnapshotHolder {
+public:
+    SnapshotHolder() = default;
+    SnapshotHolder(const SnapshotHolder&) = delete;
+    SnapshotHolder& operator=(const SnapshotHolder&) = delete;
+
+    // Возвращает текущую версию (nullptr, если ничего не опубликовано)
+    std::shared_ptr<const Snapshot> Acquire() const;
+
+    // Делает snapshot текущей версией. Дожидается, пока читатели, начавшие Acquire до замены,
+    // возьмут ссылку на свою версию, поэтому может ненадолго ожидать
+    void Publish(std::shared_ptr<const Snapshot> snapshot);
+
+private:
+    // Счётчик читателей, выровненный по строке кэша, чтобы эпохи не мешали друг другу
+    struct alignas(64) ReaderCounter {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::atomic<const Snapshot*> current_{nullptr};  // Текущая версия для читателей
+    std::atomic<unsigned> epoch_{0};                 // Номер эпохи читателей (0 или 1)
+    mutable ReaderCounter readers_[2];               // Читатели внутри Acquire по эпохам
+
+    std::mutex publish_mutex_;                       // Упорядочивает публикации (только писатели)
+    std::shared_ptr<const Snapshot> owner_;          // Владеющая ссылка на текущую версию
+};
+
+} // namespace transport
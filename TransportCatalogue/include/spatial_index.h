@@ -0,0 +1,60 @@
+#pragma once
+
+#include "geo.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace geo {
+
+// Найденная точка: индекс и расстояние до центра запроса в метрах
+using PointDistance = std::pair<uint32_t, double>;
+
+// Пространственный индекс точек на равномерной сетке по широте и долготе.
+// Ширина ячейки по долготе подбирается так, чтобы ячейки были примерно квадратными в метрах.
+// Запросы просматривают только ячейки, пересекающие область поиска, а затем
+// отбирают точки по расстоянию, вычисленному пакетно (geo::ComputeDistancesFrom).
+// Переход через меридиан 180° не поддерживается.
+class GridIndex {
+public:
+    GridIndex() = default;
+
+    // Строит индекс; индексы точек в ответах совпадают с их позициями в points
+    explicit GridIndex(const std::vector<Coordinates>& points);
+
+    // Возвращает точки не дальше radius метров от center, упорядоченные по расстоянию
+    std::vector<PointDistance> FindWithinRadius(Coordinates center, double radius) const;
+
+    // Возвращает count ближайших к center точек, упорядоченных по расстоянию
+    std::vector<PointDistance> FindNearest(Coordinates center, size_t count) const;
+
+    // Занимаемая память
+    memory::Usage GetMemoryUsage() const;
+
+private:
+    // Номер строки или столбца ячейки, возможно за пределами сетки
+    int GetRow(double lat) const;
+    int GetColumn(double lng) const;
+
+    // Нижняя граница расстояния от center до точек вне квадрата ячеек со сторонами
+    // [row - half, row + half] и [column - half, column + half]
+    double GetOutsideDistance(Coordinates center, int row, int column, int half) const;
+
+    // Добавляет в result точки ячеек строки row со столбцами [first_column, last_column]
+    // не дальше max_distance от center. Точки этих ячеек идут в cell_points_ подряд
+    void CollectCells(int row, int first_column, int last_column, SpherePoint center, double max_distance, std::vector<PointDistance>& result) const;
+
+    SpherePoints points_;                 // Точки на единичной сфере
+    std::vector<uint32_t> cell_offsets_;  // Начала ячеек в cell_points_ (размер - число ячеек + 1)
+    std::vector<uint32_t> cell_points_;   // Индексы точек, сгруппированные по ячейкам
+
+    double min_lat_ = 0;                  // Южная граница сетки
+    double min_lng_ = 0;                  // Западная граница сетки
+    double cell_lat_ = 1;                 // Высота ячейки в градусах
+    double cell_lng_ = 1;                 // Ширина ячейки в градусах
+    int rows_ = 0;
+    int columns_ = 0;
+};
+
+} // namespace geo
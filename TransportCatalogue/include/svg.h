@@ -1,5 +1,7 @@
 #pragma once
 
+#include "memory_usage.h"
+
 #include <cstdint>
 #include <iostream>
 #include <memory>
@@ -128,6 +130,9 @@ class Object {
 public:
     void Render(const RenderContext& context) const;
 
+    // Добавляет в отчёт память, занимаемую объектом, в составляющую его вида
+    virtual void AddMemoryUsage(memory::Usage& usage) const = 0;
+
     virtual ~Object() = default;
 
 private:
@@ -195,6 +200,17 @@ public:
 protected:
     ~PathProps() = default;
 
+    // Динамическая память цветов, заданных названием
+    size_t GetAttrsMemory() const {
+        size_t bytes = 0;
+        for (const auto* color : {&fill_color_, &stroke_color_}) {
+            if (*color && std::holds_alternative<std::string>(**color)) {
+                bytes += memory::StringBytes(std::get<std::string>(**color));
+            }
+        }
+        return bytes;
+    }
+
     void RenderAttrs(std::ostream& out) const {
         using namespace std::literals;
 
@@ -243,6 +259,8 @@ public:
     Circle& SetCenter(Point center);
     Circle& SetRadius(double radius);
 
+    void AddMemoryUsage(memory::Usage& usage) const override;
+
 private:
     void RenderObject(const RenderContext& context) const override;
 
@@ -259,6 +277,8 @@ public:
     // Добавляет очередную вершину к ломаной линии
     Polyline& AddPoint(Point point);
 
+    void AddMemoryUsage(memory::Usage& usage) const override;
+
 private:
     void RenderObject(const RenderContext& context) const override;
     std::vector<Point> points_;
@@ -288,6 +308,8 @@ public:
     // Задаёт текстовое содержимое объекта (отображается внутри тега text)
     Text& SetData(std::string data);
 
+    void AddMemoryUsage(memory::Usage& usage) const override;
+
 private:
     void RenderObject(const RenderContext& context) const override;
 
@@ -306,6 +328,9 @@ public:
     
     // Выводит в ostream svg-представление документа
     void Render(std::ostream& out) const;
+
+    // Занимаемая память с разбивкой по видам объектов
+    memory::Usage GetMemoryUsage() const;
     
 private:
     std::vector<std::unique_ptr<Object>> objects_;
@@ -2,6 +2,10 @@
 
 #include "geo.h"
 #include "domain.h"
+#include "name_arena.h"
+#include "name_search.h"
+#include "ranges.h"
+#include "spatial_index.h"
 
 #include <iostream>
 #include <deque>
@@ -10,7 +14,6 @@
 #include <vector>
 #include <stdexcept>
 #include <optional>
-#include <unordered_set>
 #include <set>
 #include <map>
 
@@ -18,13 +21,22 @@ namespace transport {
 
 class Catalogue {
 public:
-    struct StopDistancesHasher {
-        size_t operator()(const std::pair<const Stop*, const Stop*>& points) const {
-            size_t hash_first = std::hash<const void*>{}(points.first);
-            size_t hash_second = std::hash<const void*>{}(points.second);
-            return hash_first + hash_second * 37;
-        }
-    };
+    // Диапазон идентификаторов автобусов, проходящих через остановку (отсортирован по номеру)
+    using BusIdRange = ranges::Range<std::vector<uint32_t>::const_iterator>;
+
+    // Последовательность идентификаторов остановок маршрута в порядке следования
+    using StopIdRange = ranges::Range<std::vector<uint32_t>::const_iterator>;
+
+    // Диапазоны маршрутов и остановок, упорядоченных по имени
+    using BusRange = ranges::Range<std::vector<const Bus*>::const_iterator>;
+    using StopRange = ranges::Range<std::vector<const Stop*>::const_iterator>;
+
+    // Найденная остановка и расстояние до неё в метрах
+    using NearbyStop = std::pair<const Stop*, double>;
+
+    // Найденные по имени остановка или маршрут и расстояние редактирования до запроса
+    using StopMatch = std::pair<const Stop*, int>;
+    using BusMatch = std::pair<const Bus*, int>;
 
     // Добавляет остановку в каталог
     void AddStop(std::string_view stop_name, const geo::Coordinates coordinates);
@@ -41,21 +53,101 @@ public:
     // Устанавливает расстояние между двумя остановками
     void SetDistance(const Stop* from, const Stop* to, const int distance);
 
-    // Получает расстояние между двумя остановками
+    // Получает расстояние между двумя остановками (при отсутствии - расстояние в обратном направлении).
+    // Доступно после Freeze()
     int GetDistance(const Stop* from, const Stop* to) const;
+    int GetDistance(uint32_t from_id, uint32_t to_id) const;
 
-    // Возвращает все маршруты, отсортированные по номеру
-    const std::map<std::string_view, const Bus*> GetSortedAllBuses() const;
-    
-    // Возвращает все остановки, отсортированные по имени
-    const std::map<std::string_view, const Stop*> GetSortedAllStops() const;
+    // Возвращает координаты остановки
+    geo::Coordinates GetCoordinates(const Stop& stop) const;
+
+    // Возвращает идентификаторы остановок маршрута (для некругового маршрута - только прямое направление)
+    StopIdRange GetBusStops(const Bus& bus) const;
 
-    // Получение статистики по маршруту
+    // Проверяет, является ли маршрут круговым
+    bool IsRoundTrip(const Bus& bus) const;
+
+    // Возвращает все маршруты, отсортированные по номеру. Доступно после Freeze()
+    BusRange GetSortedAllBuses() const;
+
+    // Возвращает все остановки, отсортированные по имени. Доступно после Freeze()
+    StopRange GetSortedAllStops() const;
+
+    // Получение статистики по маршруту, вычисленной при заморозке. Доступно после Freeze()
     BusStat GetRouteInfo(const Bus& route) const;
 
+    // Завершает загрузку: строит индексы только для чтения. После вызова каталог нельзя изменять.
+    // Статистика маршрутов вычисляется не более чем на threads потоках
+    void Freeze(size_t threads = 1);
+
+    // Проверяет, завершена ли загрузка каталога
+    bool IsFrozen() const;
+
+    // Возвращает идентификаторы автобусов, проходящих через остановку. Доступно после Freeze()
+    BusIdRange GetBusesByStop(const Stop& stop) const;
+
+    // Возвращает маршрут по его идентификатору
+    const Bus& GetBus(uint32_t bus_id) const;
+
+    // Возвращает остановку по её идентификатору
+    const Stop& GetStop(uint32_t stop_id) const;
+
+    // Возвращает остановки не дальше radius метров от точки, по возрастанию расстояния. Доступно после Freeze()
+    std::vector<NearbyStop> FindStopsWithinRadius(geo::Coordinates center, double radius) const;
+
+    // Возвращает count ближайших к точке остановок, по возрастанию расстояния. Доступно после Freeze()
+    std::vector<NearbyStop> FindNearestStops(geo::Coordinates center, size_t count) const;
+
+    // Возвращает не более limit остановок, название которых начинается с query с точностью до
+    // max_distance опечаток (не больше NameSearchIndex::MAX_DISTANCE). Доступно после Freeze()
+    std::vector<StopMatch> SearchStops(std::string_view query, size_t limit, int max_distance) const;
+
+    // То же для номеров маршрутов. Доступно после Freeze()
+    std::vector<BusMatch> SearchBuses(std::string_view query, size_t limit, int max_distance) const;
+
+    // Возвращает общее хранилище имён остановок и маршрутов
+    const NameArena& GetNames() const;
+
+    // Занимаемая память с разбивкой по внутренним массивам и индексам
+    memory::Usage GetMemoryUsage() const;
+
 private:
-    // Возвращает количество уникальных остановок для указанного маршрута
-    size_t UniqueStopsCount(std::string_view bus_number) const;
+    // Выбрасывает исключение, если каталог уже заморожен
+    void CheckNotFrozen() const;
+    // Выбрасывает исключение, если каталог ещё не заморожен
+    void CheckFrozen() const;
+
+    // Строит упорядоченные по имени списки маршрутов и остановок
+    void BuildSortedIndices();
+
+    // Строит общий массив автобусов по остановкам, упорядоченный по номерам маршрутов
+    void BuildStopBusesIndex();
+
+    // Строит упорядоченные списки смежности расстояний (CSR по идентификатору остановки)
+    void BuildDistancesIndex();
+
+    // Строит пространственный индекс остановок
+    void BuildStopIndex();
+
+    // Строит индексы поиска по названиям остановок и номерам маршрутов
+    void BuildSearchIndices();
+
+    // Освобождает запас ёмкости массивов, заполненных при загрузке
+    void ShrinkStorage();
+
+    // Заменяет индексы точек пространственного индекса на остановки
+    std::vector<NearbyStop> ToNearbyStops(const std::vector<geo::PointDistance>& points) const;
+
+    // Вычисляет статистику всех маршрутов, распределяя их между потоками
+    void ComputeBusStats(size_t threads);
+
+    // Рабочие массивы для подсчёта статистики, переиспользуемые между маршрутами одного потока
+    struct RouteInfoBuffers {
+        std::vector<uint32_t> stop_marks;  // Отметки встреченных остановок (размер - число остановок)
+    };
+
+    // Вычисляет статистику маршрута
+    BusStat ComputeRouteInfo(const Bus& bus, RouteInfoBuffers& buffers) const;
 
     // Хранит все маршруты в очереди
     std::deque<Bus> all_buses_;
@@ -63,14 +155,68 @@ private:
     // Хранит все остановки в очереди
     std::deque<Stop> all_stops_;
 
-    // Отображение имени маршрута на указатель на объект маршрута
-    std::unordered_map<std::string_view, const Bus*> busname_to_bus_;
+    // Широты и долготы остановок (индекс - идентификатор остановки)
+    std::vector<double> stop_lats_;
+    std::vector<double> stop_lngs_;
+
+    // Идентификаторы остановок всех маршрутов подряд
+    std::vector<uint32_t> route_stops_;
+
+    // Начала последовательностей маршрутов в route_stops_ (размер - число маршрутов + 1)
+    std::vector<uint32_t> route_offsets_ = { 0 };
+
+    // Признаки кольцевых маршрутов, по биту на маршрут
+    std::vector<uint64_t> round_trips_;
+
+    // Единичные векторы остановок для пакетного вычисления расстояний (индекс - идентификатор остановки)
+    geo::SpherePoints stop_points_;
+
+    // Пространственный индекс остановок (индекс точки - идентификатор остановки)
+    geo::GridIndex stop_index_;
+
+    // Интернированные имена остановок и маршрутов
+    NameArena names_;
+
+    // Индексы поиска по началу имени; позиции совпадают с sorted_stops_ и sorted_buses_
+    NameSearchIndex stop_search_;
+    NameSearchIndex bus_search_;
+
+    // Отображение идентификатора имени на маршрут (nullptr, если это не номер маршрута)
+    std::vector<const Bus*> bus_by_name_;
+
+    // Отображение идентификатора имени на остановку (nullptr, если это не название остановки)
+    std::vector<const Stop*> stop_by_name_;
+
+    // Расстояние от одной остановки до другой
+    struct StopDistance {
+        uint32_t from;  // Идентификатор начальной остановки
+        uint32_t to;    // Идентификатор конечной остановки
+        int distance;   // Расстояние по дорогам
+    };
+
+    // Расстояния, заданные при загрузке, в порядке добавления
+    std::vector<StopDistance> pending_distances_;
+
+    // Начала списков смежности остановок в distance_targets_/distance_values_ (размер - число остановок + 1)
+    std::vector<uint32_t> distance_offsets_;
+
+    // Конечные остановки, отсортированные внутри списка каждой начальной остановки
+    std::vector<uint32_t> distance_targets_;
+
+    // Расстояния, соответствующие distance_targets_
+    std::vector<int> distance_values_;
+
+    // Маршруты, упорядоченные по номеру
+    std::vector<const Bus*> sorted_buses_;
+
+    // Остановки, упорядоченные по названию
+    std::vector<const Stop*> sorted_stops_;
 
-    // Отображение имени остановки на указатель на объект остановки
-    std::unordered_map<std::string_view, const Stop*> stopname_to_stop_;
+    // Идентификаторы автобусов всех остановок подряд; остановка ссылается на свой отрезок
+    std::vector<uint32_t> stop_buses_;
 
-    // Отображение пары остановок на расстояние между ними 
-    std::unordered_map<std::pair<const Stop*, const Stop*>, int, StopDistancesHasher> stop_distances_;
+    // Признак завершённой загрузки
+    bool frozen_ = false;
 };
 
 } // namespace transport
@@ -4,6 +4,7 @@
 #include "transport_catalogue.h"
 
 #include <memory>
+#include <vector>
 
 namespace transport {
 
@@ -11,47 +12,62 @@ class Router {
 public:
     Router() = default;
     
-    // Конструктор с параметрами для установки времени ожидания автобуса и его скорости
-	explicit Router(const int bus_wait_time, const double bus_velocity)
+    // Конструктор с параметрами для установки времени ожидания автобуса и его скорости.
+    // Если заданы скорость пешехода (км/ч) и наибольшее расстояние пешей пересадки (м),
+    // в граф добавляются пешие переходы между близкими остановками
+	explicit Router(const int bus_wait_time, const double bus_velocity, const double walk_velocity = 0.0, const double max_walk_distance = 0.0)
 		: bus_wait_time_(bus_wait_time)
-		, bus_velocity_(bus_velocity) {}
-
-    // Конструктор копирования, который также строит граф маршрутизации на основе предоставленного каталога
-	Router(const Router& settings, const Catalogue& catalogue) {
-		bus_wait_time_ = settings.bus_wait_time_;
-		bus_velocity_ = settings.bus_velocity_;
-		BuildGraph(catalogue);
-	}
+		, bus_velocity_(bus_velocity)
+		, walk_velocity_(walk_velocity)
+		, max_walk_distance_(max_walk_distance) {}
 
     // Строит граф маршрутизации на основе данных из каталога
     void BuildGraph(const Catalogue& catalogue);
       
     // Находит оптимальный маршрут между двумя остановками и возвращает информацию о маршруте
-    const std::optional<graph::Router<double>::RouteInfo> FindRoute(const std::string_view stop_from, const std::string_view stop_to) const;
+    const std::optional<graph::Router<double>::RouteInfo> FindRoute(const Stop& stop_from, const Stop& stop_to) const;
     
     // Возвращает граф маршрутизации, который используется для поиска маршрутов
     const graph::DirectedWeightedGraph<double>& GetGraph() const;
 
+    // Проверяет, является ли ребро пешим переходом между остановками
+    bool IsWalkEdge(graph::EdgeId edge_id) const;
+
+    // Занимаемая память: граф, таблица маршрутов и соответствие остановок вершинам
+    memory::Usage GetMemoryUsage() const;
+
     // Можете подсказать, что именно мне нужно сделать, поскольку метод GetGraph у меня используется в request_handler и json_reader (PrintRouting) я честно не совсем понимаю, что мне нужно сделать.
     // Провел весь день пытаясь устранить зависимость этого метода в других частях кода, но все безуспешно. Простите может за нелепый вопрос, а нельзя ли оставить этот метод или насколько сильно это влияет на работу программы?
 
 private:
+    // Значение для остановок, не попавших в граф
+    static constexpr graph::VertexId NO_VERTEX = static_cast<graph::VertexId>(-1);
+
     // Время ожидания автобуса на остановке 
     int bus_wait_time_ = 0;
     // Средняя скорость автобуса 
     double bus_velocity_ = 0.0;     
+    // Скорость пешехода (0 - пешие переходы не строятся)
+    double walk_velocity_ = 0.0;
+    // Наибольшее расстояние пешего перехода между остановками в метрах
+    double max_walk_distance_ = 0.0;
 
     // Граф маршрутизации, представляющий собой ориентированный граф с весами
     graph::DirectedWeightedGraph<double> graph_; 
-    // Отображение имен остановок на идентификаторы вершин в графе
-    std::map<std::string, graph::VertexId> stop_ids_; 
+    // Идентификаторы вершин ожидания в графе по идентификаторам остановок
+    std::vector<graph::VertexId> stop_vertices_;
+    // Рёбра пеших переходов занимают непрерывный диапазон идентификаторов [begin, end)
+    graph::EdgeId walk_edges_begin_ = 0;
+    graph::EdgeId walk_edges_end_ = 0;
     // Указатель на объект маршрутизатора, который использует граф для поиска маршрутов
     std::unique_ptr<graph::Router<double>> router_;    
     
     // Вспомогательный метод, добавляет рёбра для всех остановок в граф маршрутизации
-    void AddBusEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, const std::map<std::string, graph::VertexId>& stop_ids);
+    void AddBusEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, const std::vector<graph::VertexId>& stop_vertices);
     // Вспомогательный метод, добавляет рёбра для всех автобусных маршрутов в граф маршрутизации
-    void AddStopEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, std::map<std::string, graph::VertexId>& stop_ids);
+    void AddStopEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, std::vector<graph::VertexId>& stop_vertices);
+    // Вспомогательный метод, добавляет рёбра пеших переходов между близкими остановками
+    void AddWalkEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, const std::vector<graph::VertexId>& stop_vertices);
 };
     
 } // namespace transport
\ No newline at end of file
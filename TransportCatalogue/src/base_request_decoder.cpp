@@ -0,0 +1,484 @@
+#include "base_request_decoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::literals;
+
+namespace {
+
+// Наименьший размер входных данных, при котором раздел base_requests разбирается параллельно
+constexpr size_t MIN_PARALLEL_INPUT = 16 << 20;
+
+// Наименьший размер части раздела
+constexpr size_t MIN_PART_SIZE = 1 << 20;
+
+// Частей на поток: несколько частей на поток выравнивают нагрузку потоков
+constexpr size_t PARTS_PER_THREAD = 4;
+
+// Задачи с номерами [0, count), которые рабочие потоки берут по порядку номеров.
+// Вызывающий поток может дождаться завершения отдельной задачи, пока остальные выполняются
+class OrderedTasks {
+public:
+    OrderedTasks(size_t count, size_t threads, std::function<void(size_t)> task)
+        : task_(std::move(task))
+        , done_(count, false)
+        , errors_(count) {
+        for (size_t i = 0; i < std::min(threads, count); ++i) {
+            workers_.emplace_back([this] { Work(); });
+        }
+    }
+
+    ~OrderedTasks() {
+        Join();
+    }
+
+    // Ожидает завершения задачи index и выбрасывает её исключение, если оно было
+    void Wait(size_t index) {
+        std::unique_lock lock(mutex_);
+        task_done_.wait(lock, [this, index] { return done_[index]; });
+        if (errors_[index]) {
+            std::rethrow_exception(errors_[index]);
+        }
+    }
+
+    // Ожидает все задачи и выбрасывает исключение первой по номеру задачи, завершившейся с ошибкой
+    void WaitAll() {
+        Join();
+        for (const std::exception_ptr& error : errors_) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+private:
+    void Work() {
+        for (size_t index = next_++; index < done_.size(); index = next_++) {
+            std::exception_ptr error;
+            try {
+                task_(index);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard lock(mutex_);
+            errors_[index] = error;
+            done_[index] = true;
+            task_done_.notify_all();
+        }
+    }
+
+    void Join() {
+        for (std::thread& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    std::function<void(size_t)> task_;
+    std::atomic<size_t> next_ = 0;       // Первая ещё не выданная задача
+    std::mutex mutex_;
+    std::condition_variable task_done_;
+    std::vector<bool> done_;
+    std::vector<std::exception_ptr> errors_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace
+
+CatalogueFiller::CatalogueFiller(transport::Catalogue& catalogue)
+    : catalogue_(catalogue) {
+}
+
+// Остановка добавляется сразу; расстояния до ещё не описанных остановок откладываются
+void CatalogueFiller::AddStop(const StopRequest& request) {
+    catalogue_.AddStop(request.name, request.coordinates);
+    const transport::Stop* from = catalogue_.FindStop(request.name);
+    for (const auto& [to_name, distance] : request.road_distances) {
+        if (const transport::Stop* to = catalogue_.FindStop(to_name)) {
+            catalogue_.SetDistance(from, to, distance);
+        } else {
+            pending_distances_.push_back({ from->id, to_name, distance });
+        }
+    }
+}
+
+// Маршрут добавляется сразу, если известны все его остановки и нет отложенных маршрутов
+// перед ним: так идентификаторы маршрутов совпадают с порядком ввода
+void CatalogueFiller::AddBus(const BusRequest& request) {
+    if (pending_buses_.empty()) {
+        route_stops_.clear();
+        for (const std::string& stop_name : request.stops) {
+            const transport::Stop* stop = catalogue_.FindStop(stop_name);
+            if (!stop) {
+                break;
+            }
+            route_stops_.push_back(stop);
+        }
+        if (route_stops_.size() == request.stops.size()) {
+            catalogue_.AddRoute(request.number, route_stops_, request.is_roundtrip);
+            return;
+        }
+    }
+    pending_buses_.push_back({ std::string(request.number), std::vector<std::string>(request.stops.begin(), request.stops.end()), request.is_roundtrip });
+}
+
+void CatalogueFiller::Finish() {
+    for (const PendingDistance& pending : pending_distances_) {
+        const transport::Stop* to = catalogue_.FindStop(pending.to);
+        if (!to) {
+            throw std::invalid_argument("Unknown stop '"s + pending.to + "'"s);
+        }
+        catalogue_.SetDistance(&catalogue_.GetStop(pending.from_id), to, pending.distance);
+    }
+    pending_distances_.clear();
+
+    for (const PendingBus& pending : pending_buses_) {
+        route_stops_.clear();
+        for (const std::string& stop_name : pending.stops) {
+            const transport::Stop* stop = catalogue_.FindStop(stop_name);
+            if (!stop) {
+                throw std::invalid_argument("Unknown stop '"s + stop_name + "'"s);
+            }
+            route_stops_.push_back(stop);
+        }
+        catalogue_.AddRoute(pending.number, route_stops_, pending.is_roundtrip);
+    }
+    pending_buses_.clear();
+}
+
+void BaseRequestFragment::AddStop(const StopRequest& request) {
+    distances_.insert(distances_.end(), request.road_distances.begin(), request.road_distances.end());
+    requests_.push_back({ true, std::string(request.name), request.coordinates, false, distances_.size() });
+}
+
+void BaseRequestFragment::AddBus(const BusRequest& request) {
+    stops_.insert(stops_.end(), request.stops.begin(), request.stops.end());
+    requests_.push_back({ false, std::string(request.number), {}, request.is_roundtrip, stops_.size() });
+}
+
+void BaseRequestFragment::AddStopsTo(transport::Catalogue& catalogue) {
+    bool first = true;
+    for (const Request& request : requests_) {
+        if (request.is_stop) {
+            catalogue.AddStop(request.name, request.coordinates);
+            // Остановки получают идентификаторы подряд, поэтому достаточно запомнить первый
+            if (first) {
+                first_stop_id_ = catalogue.FindStop(request.name)->id;
+                first = false;
+            }
+        }
+    }
+}
+
+void BaseRequestFragment::ResolveStops(const transport::Catalogue& catalogue) {
+    auto resolve = [&catalogue](const std::string& name) {
+        const transport::Stop* stop = catalogue.FindStop(name);
+        if (!stop) {
+            throw std::invalid_argument("Unknown stop '"s + name + "'"s);
+        }
+        return stop;
+    };
+    distance_stops_.clear();
+    for (const auto& [to_name, distance] : distances_) {
+        distance_stops_.push_back(resolve(to_name));
+    }
+    route_stops_.clear();
+    for (const std::string& stop_name : stops_) {
+        route_stops_.push_back(resolve(stop_name));
+    }
+}
+
+void BaseRequestFragment::AddDistancesTo(transport::Catalogue& catalogue, bool backward) const {
+    uint32_t from_id = first_stop_id_;
+    size_t distances_begin = 0;
+    for (const Request& request : requests_) {
+        if (!request.is_stop) {
+            continue;
+        }
+        const transport::Stop* from = &catalogue.GetStop(from_id++);
+        for (size_t i = distances_begin; i < request.end; ++i) {
+            if ((distance_stops_[i]->id <= from->id) == backward) {
+                catalogue.SetDistance(from, distance_stops_[i], distances_[i].second);
+            }
+        }
+        distances_begin = request.end;
+    }
+}
+
+void BaseRequestFragment::AddRoutesTo(transport::Catalogue& catalogue) const {
+    std::vector<const transport::Stop*> stops;
+    size_t stops_begin = 0;
+    for (const Request& request : requests_) {
+        if (!request.is_stop) {
+            stops.assign(route_stops_.begin() + stops_begin, route_stops_.begin() + request.end);
+            catalogue.AddRoute(request.name, stops, request.is_roundtrip);
+            stops_begin = request.end;
+        }
+    }
+}
+
+BaseRequestDecoder::BaseRequestDecoder(BaseRequestSink& sink)
+    : sink_(sink) {
+}
+
+void BaseRequestDecoder::StartInsideArray() {
+    state_ = State::REQUESTS;
+}
+
+void BaseRequestDecoder::StartObject() {
+    if (Skip(1)) {
+        return;
+    }
+    if (state_ == State::REQUESTS) {
+        BeginRequest();
+        state_ = State::REQUEST;
+    } else if (state_ == State::REQUEST && field_ == Field::ROAD_DISTANCES) {
+        distances_count_ = 0;
+        state_ = State::DISTANCES;
+    } else if (state_ == State::REQUEST && field_ == Field::NONE) {
+        skip_depth_ = 1;
+    } else {
+        Unexpected("object"sv);
+        skip_depth_ = 1;
+    }
+}
+
+void BaseRequestDecoder::Key(std::string_view key) {
+    if (Skip(0)) {
+        return;
+    }
+    if (state_ == State::DISTANCES) {
+        if (distances_count_ == distances_.size()) {
+            distances_.emplace_back();
+        }
+        distances_[distances_count_].first.assign(key);
+        return;
+    }
+    if (key == "type"sv) {
+        field_ = Field::TYPE;
+    } else if (key == "name"sv) {
+        field_ = Field::NAME;
+    } else if (key == "latitude"sv) {
+        field_ = Field::LATITUDE;
+    } else if (key == "longitude"sv) {
+        field_ = Field::LONGITUDE;
+    } else if (key == "road_distances"sv) {
+        field_ = Field::ROAD_DISTANCES;
+    } else if (key == "stops"sv) {
+        field_ = Field::STOPS;
+    } else if (key == "is_roundtrip"sv) {
+        field_ = Field::IS_ROUNDTRIP;
+    } else {
+        field_ = Field::NONE;
+    }
+}
+
+void BaseRequestDecoder::EndObject() {
+    if (Skip(-1)) {
+        return;
+    }
+    if (state_ == State::DISTANCES) {
+        state_ = State::REQUEST;
+    } else {
+        EndRequest();
+        state_ = State::REQUESTS;
+    }
+}
+
+void BaseRequestDecoder::StartArray() {
+    if (Skip(1)) {
+        return;
+    }
+    if (state_ == State::START) {
+        state_ = State::REQUESTS;
+    } else if (state_ == State::REQUEST && field_ == Field::STOPS) {
+        stops_count_ = 0;
+        state_ = State::STOPS;
+    } else if (state_ == State::REQUEST && field_ == Field::NONE) {
+        skip_depth_ = 1;
+    } else {
+        Unexpected("array"sv);
+        skip_depth_ = 1;
+    }
+}
+
+void BaseRequestDecoder::EndArray() {
+    if (Skip(-1)) {
+        return;
+    }
+    state_ = state_ == State::STOPS ? State::REQUEST : State::DONE;
+}
+
+void BaseRequestDecoder::String(std::string_view value) {
+    if (Skip(0)) {
+        return;
+    }
+    if (state_ == State::STOPS) {
+        StoreString(stop_names_, stops_count_, value);
+    } else if (state_ == State::REQUEST && field_ == Field::TYPE) {
+        type_ = value == "Stop"sv ? RequestType::STOP
+              : value == "Bus"sv ? RequestType::BUS
+              : RequestType::UNKNOWN;
+    } else if (state_ == State::REQUEST && field_ == Field::NAME) {
+        name_.assign(value);
+    } else if (state_ != State::REQUEST || field_ != Field::NONE) {
+        Unexpected("string"sv);
+    }
+}
+
+void BaseRequestDecoder::Int(int value) {
+    if (Skip(0)) {
+        return;
+    }
+    if (state_ == State::DISTANCES) {
+        distances_[distances_count_++].second = value;
+    } else {
+        SetNumber(value);
+    }
+}
+
+void BaseRequestDecoder::Double(double value) {
+    if (Skip(0)) {
+        return;
+    }
+    SetNumber(value);
+}
+
+void BaseRequestDecoder::Bool(bool value) {
+    if (Skip(0)) {
+        return;
+    }
+    if (state_ == State::REQUEST && field_ == Field::IS_ROUNDTRIP) {
+        is_roundtrip_ = value;
+    } else if (state_ != State::REQUEST || field_ != Field::NONE) {
+        Unexpected("bool"sv);
+    }
+}
+
+void BaseRequestDecoder::Null() {
+    if (Skip(0)) {
+        return;
+    }
+    if (state_ != State::REQUEST || field_ != Field::NONE) {
+        Unexpected("null"sv);
+    }
+}
+
+bool BaseRequestDecoder::Skip(int delta) {
+    if (skip_depth_ == 0) {
+        return false;
+    }
+    skip_depth_ += delta;
+    return true;
+}
+
+void BaseRequestDecoder::Unexpected(std::string_view what) {
+    const bool in_request = state_ == State::REQUEST || state_ == State::DISTANCES || state_ == State::STOPS;
+    if (!in_request) {
+        throw json::ParsingError("Unexpected "s + std::string(what) + " in base_requests"s);
+    }
+    if (unexpected_.empty()) {
+        unexpected_ = what;
+    }
+}
+
+void BaseRequestDecoder::SetNumber(double value) {
+    if (state_ == State::REQUEST && field_ == Field::LATITUDE) {
+        latitude_ = value;
+    } else if (state_ == State::REQUEST && field_ == Field::LONGITUDE) {
+        longitude_ = value;
+    } else if (state_ != State::REQUEST || field_ != Field::NONE) {
+        Unexpected("number"sv);
+    }
+}
+
+void BaseRequestDecoder::StoreString(std::vector<std::string>& slots, size_t& count, std::string_view value) {
+    if (count == slots.size()) {
+        slots.emplace_back();
+    }
+    slots[count++].assign(value);
+}
+
+void BaseRequestDecoder::BeginRequest() {
+    field_ = Field::NONE;
+    type_ = RequestType::UNKNOWN;
+    name_.clear();
+    latitude_ = 0.0;
+    longitude_ = 0.0;
+    is_roundtrip_ = false;
+    distances_count_ = 0;
+    stops_count_ = 0;
+    unexpected_ = {};
+}
+
+void BaseRequestDecoder::EndRequest() {
+    if (type_ != RequestType::UNKNOWN && !unexpected_.empty()) {
+        throw json::ParsingError("Unexpected "s + std::string(unexpected_) + " in base_requests"s);
+    }
+    if (type_ == RequestType::STOP) {
+        sink_.AddStop({ name_, { latitude_, longitude_ },
+            { distances_.begin(), distances_.begin() + distances_count_ } });
+    } else if (type_ == RequestType::BUS) {
+        sink_.AddBus({ name_, { stop_names_.begin(), stop_names_.begin() + stops_count_ }, is_roundtrip_ });
+    }
+}
+
+json::Document LoadWithBaseRequests(std::shared_ptr<const json::InputBuffer> buffer, transport::Catalogue& catalogue,
+                                    size_t threads, std::unique_ptr<json::Arena> arena) {
+    const std::string_view text = buffer->GetText();
+    if (threads > 1 && text.size() >= MIN_PARALLEL_INPUT) {
+        const size_t parts = std::max<size_t>(1, std::min(threads * PARTS_PER_THREAD, text.size() / MIN_PART_SIZE));
+        // Раздела нет или он не массив: обычный разбор сообщит об этом так же, как без потоков
+        if (std::optional<json::ArraySection> section = json::SplitArraySection(text, "base_requests"sv, parts, threads)) {
+            std::vector<BaseRequestFragment> fragments(section->parts.size());
+            OrderedTasks parsing(fragments.size(), threads, [&](size_t index) {
+                BaseRequestDecoder decoder(fragments[index]);
+                decoder.StartInsideArray();
+                json::ParseArrayItems(section->parts[index], decoder);
+            });
+
+            // Пока части разбираются, вызывающий поток разбирает остальной документ, заменив в копии
+            // текста раздел пустым массивом, а затем добавляет остановки готовых фрагментов по порядку
+            std::string rest;
+            rest.reserve(text.size() - (section->end - section->begin) + 2);
+            rest.append(text.substr(0, section->begin)).append("[]"sv).append(text.substr(section->end));
+            json::Document document = json::LoadFromBuffer(json::InputBuffer::FromString(std::move(rest)), std::move(arena));
+            for (size_t i = 0; i < fragments.size(); ++i) {
+                parsing.Wait(i);
+                fragments[i].AddStopsTo(catalogue);
+            }
+            parsing.WaitAll();
+
+            OrderedTasks resolving(fragments.size(), threads, [&](size_t index) {
+                fragments[index].ResolveStops(catalogue);
+            });
+            resolving.WaitAll();
+
+            // Как при последовательном заполнении: сначала расстояния до уже описанных остановок,
+            // затем отложенные до описанных позже, затем маршруты
+            for (bool backward : {true, false}) {
+                for (const BaseRequestFragment& fragment : fragments) {
+                    fragment.AddDistancesTo(catalogue, backward);
+                }
+            }
+            for (const BaseRequestFragment& fragment : fragments) {
+                fragment.AddRoutesTo(catalogue);
+            }
+            return document;
+        }
+    }
+
+    CatalogueFiller filler(catalogue);
+    BaseRequestDecoder decoder(filler);
+    json::Document document = json::LoadFromBuffer(std::move(buffer), "base_requests"sv, decoder, std::move(arena));
+    filler.Finish();
+    return document;
+}
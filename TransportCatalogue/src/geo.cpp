@@ -1,10 +1,106 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GEO_USE_SSE2
+#endif
 
 namespace geo {
 
+namespace {
+
+// Радиус Земли в метрах
+constexpr double EARTH_RADIUS = 6371000.0;
+
+// Граница, после которой asin вычисляется через половинный угол
+constexpr double ASIN_SPLIT = 0.625;
+
+constexpr double HALF_PI = 1.57079632679489661923;
+
+// Коэффициенты рационального приближения asin(x) = x + x * z * P(z) / Q(z), z = x * x, |x| <= 0.625 (Cephes)
+constexpr double ASIN_P[] = {
+    4.253011369004428248960E-3, -6.019598008014123785661E-1, 5.444622390564711410273E0,
+    -1.626247967210700244449E1, 1.956261983317594739197E1, -8.198089802484824371615E0,
+};
+constexpr double ASIN_Q[] = {
+    1.0, -1.474091372988853791896E1, 7.049610280856842141659E1,
+    -1.471791292232726029859E2, 1.395105614657485689735E2, -4.918853881490881290097E1,
+};
+
+// Длина хорды между точкой from и точкой j на единичной сфере
+inline double ChordLength(const SpherePoints& points, SpherePoint from, uint32_t j) {
+    const double dx = from.x - points.GetX()[j];
+    const double dy = from.y - points.GetY()[j];
+    const double dz = from.z - points.GetZ()[j];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// Длина хорды между точками i и j на единичной сфере
+inline double ChordLength(const SpherePoints& points, uint32_t i, uint32_t j) {
+    return ChordLength(points, { points.GetX()[i], points.GetY()[i], points.GetZ()[i] }, j);
+}
+
+// asin(x) для x из [0, 1] тем же полиномом, что и векторная версия
+inline double FastAsin(double x) {
+    const bool reduced = x > ASIN_SPLIT;
+    const double a = reduced ? std::sqrt((1.0 - x) * 0.5) : x;
+    const double z = a * a;
+    double p = 0.0;
+    double q = 0.0;
+    for (size_t k = 0; k < std::size(ASIN_P); ++k) {
+        p = p * z + ASIN_P[k];
+        q = q * z + ASIN_Q[k];
+    }
+    const double r = a + a * z * p / q;
+    return reduced ? HALF_PI - 2.0 * r : r;
+}
+
+#ifdef GEO_USE_SSE2
+// Векторная версия FastAsin для двух значений из [0, 1]
+inline __m128d FastAsin(__m128d x) {
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d reduced = _mm_cmpgt_pd(x, _mm_set1_pd(ASIN_SPLIT));
+    const __m128d a_reduced = _mm_sqrt_pd(_mm_mul_pd(_mm_sub_pd(one, x), half));
+    const __m128d a = _mm_or_pd(_mm_and_pd(reduced, a_reduced), _mm_andnot_pd(reduced, x));
+    const __m128d z = _mm_mul_pd(a, a);
+    __m128d p = _mm_setzero_pd();
+    __m128d q = _mm_setzero_pd();
+    for (size_t k = 0; k < std::size(ASIN_P); ++k) {
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(ASIN_P[k]));
+        q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(ASIN_Q[k]));
+    }
+    const __m128d r = _mm_add_pd(a, _mm_div_pd(_mm_mul_pd(_mm_mul_pd(a, z), p), q));
+    const __m128d r_reduced = _mm_sub_pd(_mm_set1_pd(HALF_PI), _mm_add_pd(r, r));
+    return _mm_or_pd(_mm_and_pd(reduced, r_reduced), _mm_andnot_pd(reduced, r));
+}
+
+// Загружает координаты пары точек в векторный регистр
+inline __m128d Gather(const double* values, uint32_t first, uint32_t second) {
+    return _mm_set_pd(values[second], values[first]);
+}
+
+// Расстояния в метрах по разностям координат двух пар точек на единичной сфере
+inline __m128d ChordDistance(__m128d dx, __m128d dy, __m128d dz) {
+    const __m128d chord = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz)));
+    // Из-за округления половина хорды противоположных точек может чуть превысить 1
+    const __m128d half_chord = _mm_min_pd(_mm_mul_pd(chord, _mm_set1_pd(0.5)), _mm_set1_pd(1.0));
+    return _mm_mul_pd(FastAsin(half_chord), _mm_set1_pd(2.0 * EARTH_RADIUS));
+}
+#endif
+
+// Расстояние в метрах по длине хорды на единичной сфере
+inline double ChordDistance(double chord) {
+    return FastAsin(std::min(chord * 0.5, 1.0)) * 2.0 * EARTH_RADIUS;
+}
+
+} // namespace
+
 // Функция для вычисления расстояния между двумя координатами
 double ComputeDistance(Coordinates from, Coordinates to) {
     using namespace std;
@@ -23,4 +119,106 @@ double ComputeDistance(Coordinates from, Coordinates to) {
     return acos(sin(from.lat * dr) * sin(to.lat * dr) + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr)) * earth_rd;
 }
 
+SpherePoint ToSpherePoint(Coordinates coordinates) {
+    static const double dr = M_PI / 180.;
+    const double lat = coordinates.lat * dr;
+    const double lng = coordinates.lng * dr;
+    return { std::cos(lat) * std::cos(lng), std::cos(lat) * std::sin(lng), std::sin(lat) };
+}
+
+uint32_t SpherePoints::Add(Coordinates coordinates) {
+    const SpherePoint point = ToSpherePoint(coordinates);
+    x_.push_back(point.x);
+    y_.push_back(point.y);
+    z_.push_back(point.z);
+    return static_cast<uint32_t>(x_.size() - 1);
+}
+
+size_t SpherePoints::GetSize() const {
+    return x_.size();
+}
+
+const double* SpherePoints::GetX() const {
+    return x_.data();
+}
+
+const double* SpherePoints::GetY() const {
+    return y_.data();
+}
+
+const double* SpherePoints::GetZ() const {
+    return z_.data();
+}
+
+memory::Usage SpherePoints::GetMemoryUsage() const {
+    memory::Usage usage{ "SpherePoints" };
+    usage.Add("x", memory::VectorBytes(x_));
+    usage.Add("y", memory::VectorBytes(y_));
+    usage.Add("z", memory::VectorBytes(z_));
+    return usage;
+}
+
+// Пакетное вычисление расстояний: по два отрезка на векторный регистр, остаток - скалярно
+void ComputeDistances(const SpherePoints& points, const uint32_t* from, const uint32_t* to, size_t count, double* result) {
+    size_t i = 0;
+#ifdef GEO_USE_SSE2
+    const double* xs = points.GetX();
+    const double* ys = points.GetY();
+    const double* zs = points.GetZ();
+    for (; i + 2 <= count; i += 2) {
+        const __m128d dx = _mm_sub_pd(Gather(xs, from[i], from[i + 1]), Gather(xs, to[i], to[i + 1]));
+        const __m128d dy = _mm_sub_pd(Gather(ys, from[i], from[i + 1]), Gather(ys, to[i], to[i + 1]));
+        const __m128d dz = _mm_sub_pd(Gather(zs, from[i], from[i + 1]), Gather(zs, to[i], to[i + 1]));
+        _mm_storeu_pd(result + i, ChordDistance(dx, dy, dz));
+    }
+#endif
+    for (; i < count; ++i) {
+        result[i] = ChordDistance(ChordLength(points, from[i], to[i]));
+    }
+}
+
+// Расстояния от одной точки: её координаты загружаются в регистры один раз
+void ComputeDistancesFrom(const SpherePoints& points, SpherePoint from, const uint32_t* to, size_t count, double* result) {
+    size_t i = 0;
+#ifdef GEO_USE_SSE2
+    const double* xs = points.GetX();
+    const double* ys = points.GetY();
+    const double* zs = points.GetZ();
+    const __m128d from_x = _mm_set1_pd(from.x);
+    const __m128d from_y = _mm_set1_pd(from.y);
+    const __m128d from_z = _mm_set1_pd(from.z);
+    for (; i + 2 <= count; i += 2) {
+        const __m128d dx = _mm_sub_pd(from_x, Gather(xs, to[i], to[i + 1]));
+        const __m128d dy = _mm_sub_pd(from_y, Gather(ys, to[i], to[i + 1]));
+        const __m128d dz = _mm_sub_pd(from_z, Gather(zs, to[i], to[i + 1]));
+        _mm_storeu_pd(result + i, ChordDistance(dx, dy, dz));
+    }
+#endif
+    for (; i < count; ++i) {
+        result[i] = ChordDistance(ChordLength(points, from, to[i]));
+    }
+}
+
+void ComputeDistancesReference(const SpherePoints& points, const uint32_t* from, const uint32_t* to, size_t count, double* result) {
+    for (size_t i = 0; i < count; ++i) {
+        const double half_chord = std::min(ChordLength(points, from[i], to[i]) * 0.5, 1.0);
+        result[i] = std::asin(half_chord) * 2.0 * EARTH_RADIUS;
+    }
+}
+
+// Длина ломаной: отрезки считаются блоками фиксированного размера без выделения памяти
+double ComputePathLength(const SpherePoints& points, const uint32_t* path, size_t count) {
+    static constexpr size_t BLOCK = 256;
+    double distances[BLOCK];
+    double length = 0.0;
+    for (size_t begin = 0; begin + 1 < count; begin += BLOCK) {
+        const size_t segments = std::min(BLOCK, count - 1 - begin);
+        ComputeDistances(points, path + begin, path + begin + 1, segments, distances);
+        for (size_t i = 0; i < segments; ++i) {
+            length += distances[i];
+        }
+    }
+    return length;
+}
+
 } // namespace geo
@@ -0,0 +1,119 @@
+#define _USE_MATH_DEFINES
+#include "geo_check.h"
+#include "geo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace geo {
+
+namespace {
+
+// Допустимое отклонение пакетного вычисления от эталонного в метрах
+constexpr double TOLERANCE = 1e-8;
+
+// Количество пар в каждом наборе; нечётное, чтобы проверялся и скалярный остаток
+constexpr size_t PAIRS = 100001;
+
+// Количество пар с общей первой точкой, которые ComputeDistancesFrom считает одним вызовом
+constexpr size_t PAIRS_PER_POINT = 7;
+
+// Пара точек набора: вторая строится по первой
+using PairGenerator = std::function<Coordinates(Coordinates from, std::mt19937_64& random)>;
+
+// Точка, равномерно распределённая по сфере
+Coordinates RandomPoint(std::mt19937_64& random) {
+    std::uniform_real_distribution<double> sine(-1.0, 1.0);
+    std::uniform_real_distribution<double> longitude(-180.0, 180.0);
+    return { std::asin(sine(random)) * 180.0 / M_PI, longitude(random) };
+}
+
+// Сдвигает точку на случайную величину не больше max_offset градусов по каждой координате
+Coordinates Shift(Coordinates point, double max_offset, std::mt19937_64& random) {
+    std::uniform_real_distribution<double> offset(-max_offset, max_offset);
+    return { std::clamp(point.lat + offset(random), -90.0, 90.0), point.lng + offset(random) };
+}
+
+// Наибольшее отклонение от эталонных расстояний reference
+double MaxError(const std::vector<double>& distances, const std::vector<double>& reference) {
+    double max_error = 0.0;
+    for (size_t i = 0; i < distances.size(); ++i) {
+        const double error = std::abs(distances[i] - reference[i]);
+        if (std::isnan(error)) {
+            return error;
+        }
+        max_error = std::max(max_error, error);
+    }
+    return max_error;
+}
+
+// Наибольшее отклонение ComputeDistances и ComputeDistancesFrom от ComputeDistancesReference на наборе пар.
+// Первая точка меняется через каждые PAIRS_PER_POINT пар
+double MeasureMaxError(const PairGenerator& make_to, std::mt19937_64& random) {
+    SpherePoints points;
+    std::vector<Coordinates> from_points;
+    std::vector<uint32_t> from(PAIRS);
+    std::vector<uint32_t> to(PAIRS);
+    for (size_t i = 0; i < PAIRS; ++i) {
+        if (i % PAIRS_PER_POINT == 0) {
+            from_points.push_back(RandomPoint(random));
+        }
+        from[i] = points.Add(from_points.back());
+        to[i] = points.Add(make_to(from_points.back(), random));
+    }
+
+    std::vector<double> reference(PAIRS);
+    ComputeDistancesReference(points, from.data(), to.data(), PAIRS, reference.data());
+
+    std::vector<double> distances(PAIRS);
+    ComputeDistances(points, from.data(), to.data(), PAIRS, distances.data());
+    const double pairs_error = MaxError(distances, reference);
+
+    for (size_t begin = 0; begin < PAIRS; begin += PAIRS_PER_POINT) {
+        const size_t count = std::min(PAIRS_PER_POINT, PAIRS - begin);
+        ComputeDistancesFrom(points, ToSpherePoint(from_points[begin / PAIRS_PER_POINT]), to.data() + begin, count, distances.data() + begin);
+    }
+    const double from_error = MaxError(distances, reference);
+
+    if (std::isnan(pairs_error) || std::isnan(from_error)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return std::max(pairs_error, from_error);
+}
+
+} // namespace
+
+bool RunDistanceCheck(std::ostream& output) {
+    struct PairSet {
+        const char* name;
+        PairGenerator make_to;
+    };
+    const PairSet sets[] = {
+        { "random", [](Coordinates, std::mt19937_64& random) { return RandomPoint(random); } },
+        { "close", [](Coordinates from, std::mt19937_64& random) { return Shift(from, 1e-3, random); } },
+        { "very close", [](Coordinates from, std::mt19937_64& random) { return Shift(from, 1e-7, random); } },
+        { "antipodal", [](Coordinates from, std::mt19937_64& random) {
+            return Shift({ -from.lat, from.lng + 180.0 }, 1e-3, random);
+        } },
+    };
+
+    std::mt19937_64 random(42);
+    bool passed = true;
+    for (const PairSet& set : sets) {
+        const double max_error = MeasureMaxError(set.make_to, random);
+        // NaN не проходит сравнение и также считается ошибкой
+        const bool set_passed = max_error <= TOLERANCE;
+        passed = passed && set_passed;
+        output << "  " << std::left << std::setw(12) << set.name << std::right
+               << std::scientific << std::setprecision(2) << max_error << " m"
+               << (set_passed ? "" : "  FAILED") << '\n';
+    }
+    return passed;
+}
+
+} // namespace geo
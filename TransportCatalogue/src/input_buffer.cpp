@@ -0,0 +1,87 @@
+#include "input_buffer.h"
+
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JSON_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace json {
+
+std::shared_ptr<const InputBuffer> InputBuffer::MapFile(const std::string& path) {
+    std::shared_ptr<InputBuffer> buffer(new InputBuffer());
+#ifdef JSON_USE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("unable to open " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        const size_t size = static_cast<size_t>(info.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            // Файл читается один раз от начала до конца
+            ::madvise(data, size, MADV_SEQUENTIAL);
+            buffer->data_ = static_cast<const char*>(data);
+            buffer->size_ = size;
+            buffer->mapped_ = true;
+        }
+    }
+    ::close(fd);
+    if (buffer->mapped_) {
+        return buffer;
+    }
+#endif
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error("unable to open " + path);
+    }
+    return ReadStream(input);
+}
+
+std::shared_ptr<const InputBuffer> InputBuffer::ReadStream(std::istream& input) {
+    std::shared_ptr<InputBuffer> buffer(new InputBuffer());
+    buffer->storage_.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>{});
+    buffer->data_ = buffer->storage_.data();
+    buffer->size_ = buffer->storage_.size();
+    return buffer;
+}
+
+std::shared_ptr<const InputBuffer> InputBuffer::FromString(std::string text) {
+    std::shared_ptr<InputBuffer> buffer(new InputBuffer());
+    buffer->storage_ = std::move(text);
+    buffer->data_ = buffer->storage_.data();
+    buffer->size_ = buffer->storage_.size();
+    return buffer;
+}
+
+InputBuffer::~InputBuffer() {
+#ifdef JSON_USE_MMAP
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+std::string_view InputBuffer::GetText() const {
+    return {data_, size_};
+}
+
+bool InputBuffer::IsMapped() const {
+    return mapped_;
+}
+
+bool InputBuffer::Contains(std::string_view text) const {
+    // Сравнение указателей из разных объектов допустимо только через std::less
+    const std::less<const char*> less;
+    return !less(text.data(), data_) && less(text.data(), data_ + size_);
+}
+
+} // namespace json
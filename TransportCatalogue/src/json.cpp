@@ -1,354 +1,305 @@
 #include "json.h"
+#include "json_sax.h"
+#include "json_writer.h"
 
+#include <algorithm>
 #include <iterator>
+#include <new>
+#include <unordered_set>
 
 namespace json {
 
 namespace {
 using namespace std::literals;
 
-Node LoadNode(std::istream& input);
-Node LoadString(std::istream& input);
-
-std::string LoadLiteral(std::istream& input) {
-    std::string s;
-    while (std::isalpha(input.peek())) {
-        s.push_back(static_cast<char>(input.get()));
+// Обработчик SAX-разбора, собирающий дерево узлов
+class DomBuilder final : public Handler {
+public:
+    // Строки, лежащие в buffer без изменений, не копируются. Если задана arena,
+    // контейнеры и остальные строки размещаются в ней
+    DomBuilder(const InputBuffer& buffer, Arena* arena)
+        : buffer_(buffer)
+        , arena_(arena)
+        , resource_(arena != nullptr ? static_cast<std::pmr::memory_resource*>(arena) : std::pmr::get_default_resource()) {
     }
-    return s;
-}
-
-Node LoadArray(std::istream& input) {
-    std::vector<Node> result;
 
-    for (char c; input >> c && c != ']';) {
-        if (c != ',') {
-            input.putback(c);
-        }
-        result.push_back(LoadNode(input));
-    }
-    if (!input) {
-        throw ParsingError("Array parsing error"s);
+    Node ExtractRoot() {
+        return std::move(root_);
     }
-    return Node(std::move(result));
-}
 
-Node LoadDict(std::istream& input) {
-    Dict dict;
+    void StartObject() override {
+        OpenContainer& top = PushContainer();
+        top.is_dict = true;
+    }
 
-    for (char c; input >> c && c != '}';) {
-        if (c == '"') {
-            std::string key = LoadString(input).AsString();
-            if (input >> c && c == ':') {
-                if (dict.find(key) != dict.end()) {
-                    throw ParsingError("Duplicate key '"s + key + "' have been found");
+    void Key(std::string_view key) override {
+        OpenContainer& top = stack_[depth_ - 1];
+        top.key = key;
+        if (!top.keys.empty() || top.items.size() >= LINEAR_KEY_CHECK_LIMIT) {
+            if (top.keys.empty()) {
+                for (const auto& item : top.items) {
+                    top.keys.emplace(item.first);
                 }
-                dict.emplace(std::move(key), LoadNode(input));
-            } else {
-                throw ParsingError(": is expected but '"s + c + "' has been found"s);
             }
-        } else if (c != ',') {
-            throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
+            if (!top.keys.emplace(top.key).second) {
+                ThrowDuplicateKey(top.key);
+            }
+            return;
+        }
+        for (const auto& item : top.items) {
+            if (item.first == top.key) {
+                ThrowDuplicateKey(top.key);
+            }
         }
     }
-    if (!input) {
-        throw ParsingError("Dictionary parsing error"s);
+
+    void EndObject() override {
+        OpenContainer& top = stack_[depth_ - 1];
+        Node dict(Dict(std::make_move_iterator(top.items.begin()), std::make_move_iterator(top.items.end()), Dict::allocator_type(resource_)));
+        PopContainer();
+        AddValue(std::move(dict));
     }
-    return Node(std::move(dict));
-}
 
-Node LoadString(std::istream& input) {
-    auto it = std::istreambuf_iterator<char>(input);
-    auto end = std::istreambuf_iterator<char>();
-    std::string s;
-    while (true) {
-        if (it == end) {
-            throw ParsingError("String parsing error");
-        }
-        const char ch = *it;
-        if (ch == '"') {
-            ++it;
-            break;
-        } else if (ch == '\\') {
-            ++it;
-            if (it == end) {
-                throw ParsingError("String parsing error");
-            }
-            const char escaped_char = *(it);
-            switch (escaped_char) {
-                case 'n':
-                    s.push_back('\n');
-                    break;
-                case 't':
-                    s.push_back('\t');
-                    break;
-                case 'r':
-                    s.push_back('\r');
-                    break;
-                case '"':
-                    s.push_back('"');
-                    break;
-                case '\\':
-                    s.push_back('\\');
-                    break;
-                default:
-                    throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
-            }
-        } else if (ch == '\n' || ch == '\r') {
-            throw ParsingError("Unexpected end of line"s);
+    void StartArray() override {
+        OpenContainer& top = PushContainer();
+        top.is_dict = false;
+    }
+
+    void EndArray() override {
+        OpenContainer& top = stack_[depth_ - 1];
+        Node array(Array(std::make_move_iterator(top.array.begin()), std::make_move_iterator(top.array.end()), Array::allocator_type(resource_)));
+        PopContainer();
+        AddValue(std::move(array));
+    }
+
+    void String(std::string_view value) override {
+        if (buffer_.Contains(value)) {
+            AddValue(Node(BufferString{value}));
+        } else if (arena_ != nullptr) {
+            char* copy = static_cast<char*>(arena_->allocate(value.size(), 1));
+            std::copy(value.begin(), value.end(), copy);
+            AddValue(Node(BufferString{std::string_view(copy, value.size())}));
         } else {
-            s.push_back(ch);
+            AddValue(Node(std::string(value)));
         }
-        ++it;
     }
 
-    return Node(std::move(s));
-}
-
-Node LoadBool(std::istream& input) {
-    const auto s = LoadLiteral(input);
-    if (s == "true"sv) {
-        return Node{true};
-    } else if (s == "false"sv) {
-        return Node{false};
-    } else {
-        throw ParsingError("Failed to parse '"s + s + "' as bool"s);
+    void Int(int value) override {
+        AddValue(Node(value));
     }
-}
 
-Node LoadNull(std::istream& input) {
-    if (auto literal = LoadLiteral(input); literal == "null"sv) {
-        return Node{nullptr};
-    } else {
-        throw ParsingError("Failed to parse '"s + literal + "' as null"s);
+    void Double(double value) override {
+        AddValue(Node(value));
     }
-}
 
-Node LoadNumber(std::istream& input) {
-    std::string parsed_num;
+    void Bool(bool value) override {
+        AddValue(Node(value));
+    }
 
-    // Считывает в parsed_num очередной символ из input
-    auto read_char = [&parsed_num, &input] {
-        parsed_num += static_cast<char>(input.get());
-        if (!input) {
-            throw ParsingError("Failed to read number from stream"s);
-        }
-    };
+    void Null() override {
+        AddValue(Node(nullptr));
+    }
 
-    // Считывает одну или более цифр в parsed_num из input
-    auto read_digits = [&input, read_char] {
-        if (!std::isdigit(input.peek())) {
-            throw ParsingError("A digit is expected"s);
-        }
-        while (std::isdigit(input.peek())) {
-            read_char();
-        }
+private:
+    // Наибольшее количество ключей словаря, проверяемых на повтор линейным просмотром
+    static constexpr size_t LINEAR_KEY_CHECK_LIMIT = 16;
+
+    // Незавершённый массив или словарь. Элементы собираются в векторы, которые
+    // переиспользуются на той же глубине вложенности, а готовый контейнер создаётся
+    // по точному размеру
+    struct OpenContainer {
+        bool is_dict = false;
+        Array array;
+        std::vector<Dict::value_type> items;   // Пары словаря в порядке ввода
+        std::unordered_set<std::string> keys;  // Ключи большого словаря для проверки повторов
+        std::pmr::string key;                  // Ключ ожидающего значения
     };
 
-    if (input.peek() == '-') {
-        read_char();
+    [[noreturn]] static void ThrowDuplicateKey(std::string_view key) {
+        throw ParsingError("Duplicate key '"s + std::string(key) + "' have been found");
     }
-    // Парсим целую часть числа
-    if (input.peek() == '0') {
-        read_char();
-        // После 0 в JSON не могут идти другие цифры
-    } else {
-        read_digits();
+
+    OpenContainer& PushContainer() {
+        if (depth_ == stack_.size()) {
+            stack_.emplace_back();
+        }
+        return stack_[depth_++];
     }
 
-    bool is_int = true;
-    // Парсим дробную часть числа
-    if (input.peek() == '.') {
-        read_char();
-        read_digits();
-        is_int = false;
+    void PopContainer() {
+        OpenContainer& top = stack_[--depth_];
+        top.array.clear();
+        top.items.clear();
+        top.keys.clear();
     }
 
-    // Парсим экспоненциальную часть числа
-    if (int ch = input.peek(); ch == 'e' || ch == 'E') {
-        read_char();
-        if (ch = input.peek(); ch == '+' || ch == '-') {
-            read_char();
+    void AddValue(Node value) {
+        if (depth_ == 0) {
+            root_ = std::move(value);
+            return;
         }
-        read_digits();
-        is_int = false;
-    }
-
-    try {
-        if (is_int) {
-            // Сначала пробуем преобразовать строку в int
-            try {
-                return std::stoi(parsed_num);
-            } catch (...) {
-                // В случае неудачи, например, при переполнении
-                // код ниже попробует преобразовать строку в double
-            }
+        OpenContainer& top = stack_[depth_ - 1];
+        if (top.is_dict) {
+            top.items.emplace_back(std::move(top.key), std::move(value));
+        } else {
+            top.array.push_back(std::move(value));
         }
-        return std::stod(parsed_num);
-    } catch (...) {
-        throw ParsingError("Failed to convert "s + parsed_num + " to number"s);
     }
-}
 
-Node LoadNode(std::istream& input) {
-    char c;
-    if (!(input >> c)) {
-        throw ParsingError("Unexpected EOF"s);
-    }
-    switch (c) {
-        case '[':
-            return LoadArray(input);
-        case '{':
-            return LoadDict(input);
-        case '"':
-            return LoadString(input);
-        case 't':
-            // Атрибут [[fallthrough]] (провалиться) ничего не делает, и является
-            // подсказкой компилятору и человеку, что здесь программист явно задумывал
-            // разрешить переход к инструкции следующей ветки case, а не случайно забыл
-            // написать break, return или throw.
-            // В данном случае, встретив t или f, переходим к попытке парсинга
-            // литералов true либо false
-            [[fallthrough]];
-        case 'f':
-            input.putback(c);
-            return LoadBool(input);
-        case 'n':
-            input.putback(c);
-            return LoadNull(input);
-        default:
-            input.putback(c);
-            return LoadNumber(input);
+    const InputBuffer& buffer_;
+    Arena* arena_;
+    std::pmr::memory_resource* resource_;   // Арена или динамическая память
+    Node root_;
+    std::vector<OpenContainer> stack_;
+    size_t depth_ = 0;   // Количество открытых контейнеров в stack_
+};
+
+// Обработчик, передающий события значения ключа section верхнего словаря в section_handler,
+// а все остальные события - построителю дерева
+class SectionRouter final : public Handler {
+public:
+    SectionRouter(Handler& dom_builder, std::string_view section, Handler& section_handler)
+        : dom_builder_(dom_builder)
+        , section_(section)
+        , section_handler_(section_handler) {
     }
-}
 
-struct PrintContext {
-    std::ostream& out;
-    int indent_step = 4;
-    int indent = 0;
+    void StartObject() override {
+        Target(1).StartObject();
+    }
 
-    void PrintIndent() const {
-        for (int i = 0; i < indent; ++i) {
-            out.put(' ');
+    void Key(std::string_view key) override {
+        if (!in_section_ && depth_ == 1 && key == section_) {
+            in_section_ = true;
+            return;
         }
+        Target(0).Key(key);
     }
 
-    PrintContext Indented() const {
-        return {out, indent_step, indent_step + indent};
+    void EndObject() override {
+        Target(-1).EndObject();
     }
-};
 
-void PrintNode(const Node& value, const PrintContext& ctx);
+    void StartArray() override {
+        Target(1).StartArray();
+    }
 
-template <typename Value>
-void PrintValue(const Value& value, const PrintContext& ctx) {
-    ctx.out << value;
-}
+    void EndArray() override {
+        Target(-1).EndArray();
+    }
 
-void PrintString(const std::string& value, std::ostream& out) {
-    out.put('"');
-    for (const char c : value) {
-        switch (c) {
-            case '\r':
-                out << "\\r"sv;
-                break;
-            case '\n':
-                out << "\\n"sv;
-                break;
-            case '\t':
-                out << "\\t"sv;
-                break;
-            case '"':
-                // Символы " и \ выводятся как \" или \\, соответственно
-                [[fallthrough]];
-            case '\\':
-                out.put('\\');
-                [[fallthrough]];
-            default:
-                out.put(c);
-                break;
-        }
+    void String(std::string_view value) override {
+        Target(0).String(value);
     }
-    out.put('"');
-}
 
-template <>
-void PrintValue<std::string>(const std::string& value, const PrintContext& ctx) {
-    PrintString(value, ctx.out);
-}
+    void Int(int value) override {
+        Target(0).Int(value);
+    }
 
-template <>
-void PrintValue<std::nullptr_t>(const std::nullptr_t&, const PrintContext& ctx) {
-    ctx.out << "null"sv;
-}
+    void Double(double value) override {
+        Target(0).Double(value);
+    }
 
-// В специализации шаблона PrintValue для типа bool параметр value передаётся
-// по константной ссылке, как и в основном шаблоне.
-// В качестве альтернативы можно использовать перегрузку:
-// void PrintValue(bool value, const PrintContext& ctx);
-template <>
-void PrintValue<bool>(const bool& value, const PrintContext& ctx) {
-    ctx.out << (value ? "true"sv : "false"sv);
-}
+    void Bool(bool value) override {
+        Target(0).Bool(value);
+    }
 
-template <>
-void PrintValue<Array>(const Array& nodes, const PrintContext& ctx) {
-    std::ostream& out = ctx.out;
-    out << "[\n"sv;
-    bool first = true;
-    auto inner_ctx = ctx.Indented();
-    for (const Node& node : nodes) {
-        if (first) {
-            first = false;
-        } else {
-            out << ",\n"sv;
+    void Null() override {
+        Target(0).Null();
+    }
+
+private:
+    // Возвращает получателя события, меняющего вложенность на delta.
+    // Раздел заканчивается, когда его значение разобрано полностью
+    Handler& Target(int delta) {
+        if (in_section_) {
+            section_depth_ += delta;
+            if (section_depth_ == 0) {
+                in_section_ = false;
+            }
+            return section_handler_;
         }
-        inner_ctx.PrintIndent();
-        PrintNode(node, inner_ctx);
+        depth_ += delta;
+        return dom_builder_;
     }
-    out.put('\n');
-    ctx.PrintIndent();
-    out.put(']');
-}
 
-template <>
-void PrintValue<Dict>(const Dict& nodes, const PrintContext& ctx) {
-    std::ostream& out = ctx.out;
-    out << "{\n"sv;
-    bool first = true;
-    auto inner_ctx = ctx.Indented();
-    for (const auto& [key, node] : nodes) {
-        if (first) {
-            first = false;
-        } else {
-            out << ",\n"sv;
+    Handler& dom_builder_;
+    std::string_view section_;
+    Handler& section_handler_;
+    int depth_ = 0;            // Вложенность вне раздела
+    int section_depth_ = 0;    // Вложенность внутри значения раздела
+    bool in_section_ = false;  // События относятся к значению раздела
+};
+
+// Добавляет в отчёт динамическую память узла и всех вложенных узлов
+void AddNodeMemory(const Node& node, memory::Usage& usage) {
+    if (node.IsArray()) {
+        const Array& nodes = node.AsArray();
+        usage.Add("arrays"sv, memory::VectorBytes(nodes));
+        for (const Node& item : nodes) {
+            AddNodeMemory(item, usage);
         }
-        inner_ctx.PrintIndent();
-        PrintString(key, ctx.out);
-        out << ": "sv;
-        PrintNode(node, inner_ctx);
-    }
-    out.put('\n');
-    ctx.PrintIndent();
-    out.put('}');
+    } else if (node.IsDict()) {
+        const Dict& nodes = node.AsDict();
+        usage.Add("dicts"sv, nodes.capacity() * sizeof(Dict::value_type));
+        for (const auto& [key, item] : nodes) {
+            usage.Add("strings"sv, memory::StringBytes(key));
+            AddNodeMemory(item, usage);
+        }
+    } else if (const auto* value = std::get_if<std::string>(&node.GetValue())) {
+        usage.Add("strings"sv, memory::StringBytes(*value));
+    }
+}
+
+}  // namespace
+
+memory::Usage Document::GetMemoryUsage() const {
+    memory::Usage usage{"json::Document"s};
+    if (arena_) {
+        // Все узлы, контейнеры и строки документа лежат в блоках арены
+        usage.Add("arena"sv, arena_->GetReservedBytes());
+    } else {
+        usage.Add("root"sv, sizeof(Node));
+        AddNodeMemory(root_, usage);
+    }
+    if (buffer_) {
+        usage.Add(buffer_->IsMapped() ? "input_mapping"sv : "input_buffer"sv, buffer_->GetText().size());
+    }
+    return usage;
 }
 
-void PrintNode(const Node& node, const PrintContext& ctx) {
-    std::visit(
-        [&ctx](const auto& value) {
-            PrintValue(value, ctx);
-        },
-        node.GetValue());
+Document Load(std::istream& input, std::unique_ptr<Arena> arena) {
+    return LoadFromBuffer(InputBuffer::ReadStream(input), std::move(arena));
 }
 
-}  // namespace
+Document LoadFromBuffer(std::shared_ptr<const InputBuffer> buffer, std::unique_ptr<Arena> arena) {
+    DomBuilder builder(*buffer, arena.get());
+    Parse(buffer->GetText(), builder);
+    if (!arena) {
+        return Document{builder.ExtractRoot(), std::move(buffer)};
+    }
+    // Корень тоже размещается в арене, чтобы документ не вызывал деструкторы узлов
+    void* root_place = arena->allocate(sizeof(Node), alignof(Node));
+    const Node* root = new (root_place) Node(builder.ExtractRoot());
+    return Document{root, std::move(arena), std::move(buffer)};
+}
 
-Document Load(std::istream& input) {
-    return Document{LoadNode(input)};
+Document LoadFromBuffer(std::shared_ptr<const InputBuffer> buffer, std::string_view section,
+                        Handler& section_handler, std::unique_ptr<Arena> arena) {
+    DomBuilder builder(*buffer, arena.get());
+    SectionRouter router(builder, section, section_handler);
+    Parse(buffer->GetText(), router);
+    if (!arena) {
+        return Document{builder.ExtractRoot(), std::move(buffer)};
+    }
+    void* root_place = arena->allocate(sizeof(Node), alignof(Node));
+    const Node* root = new (root_place) Node(builder.ExtractRoot());
+    return Document{root, std::move(arena), std::move(buffer)};
 }
 
 void Print(const Document& doc, std::ostream& output) {
-    PrintNode(doc.GetRoot(), PrintContext{output});
+    OutputBuffer buffer(output);
+    WriteNode(doc.GetRoot(), buffer);
 }
 
-}  // namespace json
\ No newline at end of file
+}  // namespace json
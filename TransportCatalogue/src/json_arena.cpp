@@ -0,0 +1,44 @@
+#include "json_arena.h"
+
+namespace json {
+
+Arena::Arena(size_t initial_block_size)
+    : resource_(initial_block_size, &blocks_) {
+}
+
+size_t Arena::GetReservedBytes() const {
+    return blocks_.GetBytes();
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    return resource_.allocate(bytes, alignment);
+}
+
+// Отдельные участки не освобождаются: память вернётся вместе с блоками арены
+void Arena::do_deallocate(void*, size_t, size_t) {
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+size_t Arena::BlockSource::GetBytes() const {
+    return bytes_;
+}
+
+void* Arena::BlockSource::do_allocate(size_t bytes, size_t alignment) {
+    void* block = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    bytes_ += bytes;
+    return block;
+}
+
+void Arena::BlockSource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    bytes_ -= bytes;
+}
+
+bool Arena::BlockSource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // namespace json
@@ -0,0 +1,124 @@
+#include "json_benchmark.h"
+#include "input_buffer.h"
+#include "json_sax.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace json {
+
+namespace {
+
+// Количество повторов разбора каждого файла; берётся лучший результат
+constexpr int ITERATIONS = 10;
+
+// Размер синтетического входа с координатами: остановки и расстояния до соседних остановок
+constexpr int SYNTHETIC_STOPS = 20000;
+constexpr int SYNTHETIC_DISTANCES = 5;
+
+// Обработчик, который только считает события, чтобы разбор не был выброшен оптимизатором
+class CountingHandler final : public Handler {
+public:
+    void StartObject() override { ++events_; }
+    void Key(std::string_view) override { ++events_; }
+    void EndObject() override { ++events_; }
+    void StartArray() override { ++events_; }
+    void EndArray() override { ++events_; }
+    void String(std::string_view) override { ++events_; }
+    void Int(int) override { ++events_; }
+    void Double(double) override { ++events_; }
+    void Bool(bool) override { ++events_; }
+    void Null() override { ++events_; }
+
+    size_t GetEvents() const {
+        return events_;
+    }
+
+private:
+    size_t events_ = 0;
+};
+
+// Лучшее время выполнения run из ITERATIONS повторов в секундах
+double MeasureBest(const std::function<void()>& run) {
+    double best = 0.0;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void PrintResult(std::ostream& output, const char* mode, size_t bytes, double seconds) {
+    output << "  " << std::left << std::setw(10) << mode << std::right
+           << std::fixed << std::setprecision(3) << std::setw(10) << seconds * 1000.0 << " ms"
+           << std::setprecision(1) << std::setw(10) << bytes / seconds / (1024.0 * 1024.0) << " MB/s\n";
+}
+
+// Вход в формате base_requests, состоящий в основном из чисел: координаты остановок
+// с полной точностью double и целые расстояния до соседних остановок
+std::shared_ptr<const InputBuffer> MakeCoordinateInput() {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> lat(55.5, 56.0);
+    std::uniform_real_distribution<double> lng(37.3, 37.9);
+    std::uniform_int_distribution<int> distance(100, 5000);
+
+    std::ostringstream text;
+    text << std::setprecision(17) << "{\"base_requests\": [";
+    for (int i = 0; i < SYNTHETIC_STOPS; ++i) {
+        text << (i == 0 ? "" : ", ") << "{\"type\": \"Stop\", \"name\": \"" << i
+             << "\", \"latitude\": " << lat(generator) << ", \"longitude\": " << lng(generator)
+             << ", \"road_distances\": {";
+        for (int j = 0; j < SYNTHETIC_DISTANCES; ++j) {
+            const int neighbour = (i + (j + 1) * 97) % SYNTHETIC_STOPS;
+            text << (j == 0 ? "" : ", ") << '"' << neighbour << "\": " << distance(generator);
+        }
+        text << "}}";
+    }
+    text << "]}";
+
+    std::istringstream input(text.str());
+    return InputBuffer::ReadStream(input);
+}
+
+void RunOne(const std::string& title, const std::shared_ptr<const InputBuffer>& buffer, std::ostream& output) {
+    const std::string_view text = buffer->GetText();
+    output << title << ": " << text.size() << " bytes\n";
+
+    size_t events = 0;
+    const double sax_seconds = MeasureBest([&] {
+        CountingHandler handler;
+        Parse(text, handler);
+        events = handler.GetEvents();
+    });
+    PrintResult(output, "SAX", text.size(), sax_seconds);
+
+    const double dom_seconds = MeasureBest([&] {
+        const Document document = LoadFromBuffer(buffer);
+        (void)document;
+    });
+    PrintResult(output, "DOM", text.size(), dom_seconds);
+
+    const double arena_seconds = MeasureBest([&] {
+        const Document document = LoadFromBuffer(buffer, std::make_unique<Arena>(text.size()));
+        (void)document;
+    });
+    PrintResult(output, "DOM arena", text.size(), arena_seconds);
+    output << "  events: " << events << "\n";
+}
+
+} // namespace
+
+void RunParseBenchmark(const std::vector<std::string>& paths, std::ostream& output) {
+    RunOne("synthetic coordinates", MakeCoordinateInput(), output);
+    for (const std::string& path : paths) {
+        RunOne(path, InputBuffer::MapFile(path), output);
+    }
+}
+
+} // namespace json
@@ -1,14 +1,130 @@
 #include "json_reader.h"
 #include "json_builder.h"
+#include "json_writer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 using namespace std::literals;
 
-// Получение базы запросов из JSON-документа
-const json::Node& JsonReader::GetBaseRequests() const {
-    auto it = input_.GetRoot().AsDict().find("base_requests");
-    if (it == input_.GetRoot().AsDict().end()) 
-        return dummy_;
-    return it->second;
+namespace {
+
+// Очередь разобранных запросов между потоком чтения и потоком обработки.
+// Размер ограничен, чтобы быстрый источник не разбирал вход далеко впереди обработки
+class RequestQueue {
+public:
+    // Пустое значение - строка, которую не удалось разобрать
+    using Item = std::optional<json::Document>;
+
+    // Добавляет запрос, ожидая, пока в очереди освободится место
+    void Push(Item item) {
+        std::unique_lock lock(mutex_);
+        not_full_.wait(lock, [this] { return items_.size() < MAX_SIZE; });
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+    }
+
+    // Сообщает, что запросов больше не будет
+    void Close() {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_one();
+    }
+
+    // Извлекает очередной запрос; возвращает false, если очередь закрыта и пуста
+    bool Pop(Item& item) {
+        std::unique_lock lock(mutex_);
+        not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // Есть ли уже разобранные запросы, ожидающие обработки
+    bool HasPending() const {
+        std::lock_guard lock(mutex_);
+        return !items_.empty();
+    }
+
+private:
+    static constexpr size_t MAX_SIZE = 1024;
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<Item> items_;
+    bool closed_ = false;
+};
+
+// Читает строки NDJSON из input, разбирает их и передаёт в очередь; пустые строки пропускаются
+void ReadRequestLines(std::istream& input, RequestQueue& queue) {
+    std::string line;
+    while (std::getline(input, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        try {
+            queue.Push(json::LoadFromBuffer(json::InputBuffer::FromString(std::move(line))));
+        } catch (const json::ParsingError&) {
+            queue.Push(std::nullopt);
+        }
+        line.clear();
+    }
+    queue.Close();
+}
+
+// Дожидается завершения потока чтения, в том числе при выходе из обработки по исключению.
+// Оставшиеся запросы извлекаются из очереди, чтобы поток чтения не ждал в ней места
+class ReaderGuard {
+public:
+    ReaderGuard(std::thread& reader, RequestQueue& queue)
+        : reader_(reader)
+        , queue_(queue) {
+    }
+
+    ~ReaderGuard() {
+        RequestQueue::Item item;
+        while (queue_.Pop(item)) {
+        }
+        reader_.join();
+    }
+
+private:
+    std::thread& reader_;
+    RequestQueue& queue_;
+};
+
+// Возвращает словарь запроса, если строка разобрана и содержит строковое поле type
+const json::Dict* GetRequestMap(const RequestQueue::Item& request) {
+    if (!request || !request->GetRoot().IsDict()) {
+        return nullptr;
+    }
+    const json::Dict& request_map = request->GetRoot().AsDict();
+    const auto type_it = request_map.find("type"sv);
+    return type_it != request_map.end() && type_it->second.IsString() ? &request_map : nullptr;
+}
+
+// Возвращает номер запроса, если словарь запроса содержит целое поле id
+std::optional<int> GetRequestId(const json::Dict& request_map) {
+    const auto id_it = request_map.find("id"sv);
+    if (id_it == request_map.end() || !id_it->second.IsInt()) {
+        return std::nullopt;
+    }
+    return id_it->second.AsInt();
+}
+
+} // namespace
+
+// Входной JSON-документ целиком
+const json::Document& JsonReader::GetDocument() const {
+    return input_;
 }
 
 // Получение статистических запросов из JSON-документа
@@ -37,105 +153,87 @@ const json::Node& JsonReader::GetRoutingSettings() const {
 
 // Обработка статистических запросов и вывод результатов
 void JsonReader::ProcessRequests(const json::Node& stat_requests, RequestHandler& rh) const {
-    json::Array result; // Массив для хранения результатов запросов
+    // Ответы выводятся построителем сразу после обработки запроса через буфер,
+    // который передаёт их в стандартный вывод крупными порциями
+    std::cout.flush();
+    json::OutputBuffer output(json::OutputBuffer::STDOUT_FD);
+    json::StreamBuilder builder(output);
+    builder.StartArray();
     for (const auto& request : stat_requests.AsArray()) {
-        const auto& request_map = request.AsDict();
-        const auto& type = request_map.at("type").AsString();
-
-        // В зависимости от типа запроса вызываем соответствующий метод
-        if (type == "Stop") {
-            result.push_back(PrintStop(request_map, rh).AsDict());
-        } else if (type == "Bus") {
-            result.push_back(PrintRoute(request_map, rh).AsDict());
-        } else if (type == "Map") {
-            result.push_back(PrintMap(request_map, rh).AsDict());
-        } else if (type == "Route") {
-            result.push_back(PrintRouting(request_map, rh).AsDict());
-        }
+        ProcessRequest(request.AsDict(), rh, builder);
     }
-
-    // Вывод результата в поток
-    json::Print(json::Document{result}, std::cout);
-}
-
-// Заполнение каталога остановками из JSON-документа
-void JsonReader::FillCatalogue(transport::Catalogue& catalogue) {
-    const json::Array& arr = GetBaseRequests().AsArray();
-    FillStops(catalogue, arr);
-    FillStopDistances(catalogue, arr);
-    FillRoutes(catalogue, arr);
+    builder.EndArray();
+    builder.Finish();
+    output.Flush();
 }
 
-void JsonReader::FillStops(transport::Catalogue& catalogue, const json::Array& arr) const {
-    for (const auto& request_stops : arr) {
-        const auto& request_stops_map = request_stops.AsDict();
-        auto it = request_stops_map.find("type");
-        if (it != request_stops_map.end() && it->second.AsString() == "Stop") {
-            auto [stop_name, coordinates, stop_distances] = FillStop(request_stops_map);
-            catalogue.AddStop(stop_name, coordinates);
-        }
-    }
-}
-
-void JsonReader::FillStopDistances(transport::Catalogue& catalogue, const json::Array& arr) const {
-    for (const auto& request_stops : arr) {
-        const auto& request_stops_map = request_stops.AsDict();
-        auto it = request_stops_map.find("type");
-        if (it != request_stops_map.end() && it->second.AsString() == "Stop") {
-            auto [stop_name, coordinates, stop_distances] = FillStop(request_stops_map);
-            for (const auto& [to_name, dist] : stop_distances) {
-                auto from = catalogue.FindStop(stop_name);
-                auto to = catalogue.FindStop(to_name);
-                catalogue.SetDistance(from, to, dist);
+// Конвейерная обработка запросов NDJSON: разбор следующих строк идёт параллельно с обработкой
+void JsonReader::ProcessRequestStream(std::istream& input, RequestHandler& rh) const {
+    RequestQueue queue;
+    std::thread reader(ReadRequestLines, std::ref(input), std::ref(queue));
+    const ReaderGuard reader_guard(reader, queue);
+
+    // Ответы выводятся компактно, по одному в строке. Буфер сбрасывается, когда разобранных
+    // запросов больше нет: при редких запросах каждый ответ выводится сразу, а при плотном
+    // потоке ответы передаются в stdout крупными порциями
+    std::cout.flush();
+    json::OutputBuffer output(json::OutputBuffer::STDOUT_FD);
+    json::PrintOptions options;
+    options.pretty = false;
+    json::StreamBuilder builder(output, options);
+
+    RequestQueue::Item request;
+    while (queue.Pop(request)) {
+        const json::Dict* request_map = GetRequestMap(request);
+        const size_t line_begin = output.GetPosition();
+        bool processed = false;
+        try {
+            processed = request_map != nullptr && ProcessRequest(*request_map, rh, builder);
+        } catch (const std::exception&) {
+            // Поле запроса отсутствует или имеет не тот тип. Поля разбираются до начала ответа,
+            // поэтому из него ещё ничего не передано в stdout и он отбрасывается целиком.
+            // Иначе ошибка возникла при самом выводе, и продолжать поток с оборванной строкой нельзя
+            builder.Discard();
+            if (!output.Truncate(line_begin)) {
+                throw;
             }
         }
-    }
-}
-
-void JsonReader::FillRoutes(transport::Catalogue& catalogue, const json::Array& arr) const {
-    for (const auto& request_bus : arr) {
-        const auto& request_bus_map = request_bus.AsDict();
-        auto it = request_bus_map.find("type");
-        if (it != request_bus_map.end() && it->second.AsString() == "Bus") {
-            auto [bus_number, stops, circular_route] = FillRoute(request_bus_map, catalogue);
-            catalogue.AddRoute(bus_number, stops, circular_route);
+        if (!processed) {
+            const bool has_dict = request && request->GetRoot().IsDict();
+            CreateInvalidFormatResponse(has_dict ? GetRequestId(request->GetRoot().AsDict()) : std::nullopt, builder);
         }
-    }
-}
-
-std::tuple<std::string_view, geo::Coordinates, std::map<std::string_view, int>> JsonReader::FillStop(const json::Dict& request_map) const {
-    std::string_view stop_name = request_map.find("name")->second.AsString();
-    geo::Coordinates coordinates = { request_map.find("latitude")->second.AsDouble(), request_map.find("longitude")->second.AsDouble() };
-    std::map<std::string_view, int> stop_distances;
-    
-    auto it = request_map.find("road_distances");
-    if (it != request_map.end()) {
-        const auto& distances = it->second.AsDict();
-        for (const auto& [stop_name, dist] : distances) {
-            stop_distances.emplace(stop_name, dist.AsInt());
+        builder.Reset();
+        output.Put('\n');
+        if (!queue.HasPending()) {
+            output.Flush();
         }
     }
-    
-    return std::make_tuple(stop_name, coordinates, stop_distances);
+    output.Flush();
 }
 
-std::tuple<std::string_view, std::vector<const transport::Stop*>, bool> JsonReader::FillRoute(const json::Dict& request_map, transport::Catalogue& catalogue) const {
-    std::string_view bus_number = request_map.find("name")->second.AsString();
-    std::vector<const transport::Stop*> stops;
-    
-    auto it = request_map.find("stops");
-    if (it != request_map.end()) {
-        for (const auto& stop : it->second.AsArray()) {
-            stops.push_back(catalogue.FindStop(stop.AsString()));
-        }
+// Обработка одного запроса: вызывается метод, соответствующий типу запроса
+bool JsonReader::ProcessRequest(const json::Dict& request_map, RequestHandler& rh, json::StreamBuilder& builder) const {
+    const auto& type = request_map.at("type").AsString();
+    if (type == "Stop") {
+        PrintStop(request_map, rh, builder);
+    } else if (type == "Bus") {
+        PrintRoute(request_map, rh, builder);
+    } else if (type == "Map") {
+        PrintMap(request_map, rh, builder);
+    } else if (type == "Route") {
+        PrintRouting(request_map, rh, builder);
+    } else if (type == "NearbyStops") {
+        PrintNearbyStops(request_map, rh, builder);
+    } else if (type == "StopSearch") {
+        PrintNameSearch(request_map, rh, false, builder);
+    } else if (type == "BusSearch") {
+        PrintNameSearch(request_map, rh, true, builder);
+    } else {
+        return false;
     }
-    
-    bool circular_route = request_map.find("is_roundtrip")->second.AsBool();
-    
-    return std::make_tuple(bus_number, stops, circular_route);
+    return true;
 }
 
-
 // Заполнение настроек рендеринга карты из запроса
 renderer::MapRenderer JsonReader::FillRenderSettings(const json::Node& settings) const {
     json::Dict request_map = settings.AsDict();
@@ -197,6 +295,8 @@ transport::Router JsonReader::FillRoutingSettings(const json::Node& settings) co
 
     int bus_wait_time = 0;
     double bus_velocity = 0.0;
+    double walk_velocity = 0.0;
+    double max_walk_distance = 0.0;
 
     if (auto it = settings_dict.find("bus_wait_time"s); it != settings_dict.end()) {
         bus_wait_time = it->second.AsInt();
@@ -206,14 +306,23 @@ transport::Router JsonReader::FillRoutingSettings(const json::Node& settings) co
         bus_velocity = it->second.AsDouble();
     }
 
-    return transport::Router(bus_wait_time, bus_velocity);
+    // Необязательные настройки пеших переходов между остановками
+    if (auto it = settings_dict.find("walk_velocity"s); it != settings_dict.end()) {
+        walk_velocity = it->second.AsDouble();
+    }
+
+    if (auto it = settings_dict.find("max_walk_distance"s); it != settings_dict.end()) {
+        max_walk_distance = it->second.AsDouble();
+    }
+
+    return transport::Router(bus_wait_time, bus_velocity, walk_velocity, max_walk_distance);
 }
 
 
 // Вспомогательная функция для парсинга цвета
 svg::Color JsonReader::ParseColor(const json::Node& color_node) const {
     if (color_node.IsString()) {
-        return color_node.AsString();
+        return std::string(color_node.AsString());
     } else if (color_node.IsArray()) {
         const json::Array& color_array = color_node.AsArray();
         if (color_array.size() == 3) {
@@ -225,101 +334,96 @@ svg::Color JsonReader::ParseColor(const json::Node& color_node) const {
     throw std::logic_error("wrong color format");
 }
 
-// Определение функции для создания JSON-ответа с ошибкой
-json::Node JsonReader::CreateErrorResponse(int id, const std::string& error_message) const {
-    json::Builder builder;
-    return builder.StartDict()
-        .Key("request_id").Value(id)
+// Определение функции для создания JSON-ответа с ошибкой.
+// Ключи ответов задаются по возрастанию, в порядке вывода словаря
+void JsonReader::CreateErrorResponse(int id, std::string_view error_message, json::StreamBuilder& builder) const {
+    builder.StartDict()
         .Key("error_message").Value(error_message)
-    .EndDict()
-    .Build();
+        .Key("request_id").Value(id)
+    .EndDict();
+}
+
+// Ответ на запрос неверного формата: номер запроса выводится, если его удалось прочитать
+void JsonReader::CreateInvalidFormatResponse(std::optional<int> id, json::StreamBuilder& builder) const {
+    if (id) {
+        CreateErrorResponse(*id, "Invalid request format"sv, builder);
+        return;
+    }
+    builder.StartDict()
+        .Key("error_message"s).Value("Invalid request format"s)
+    .EndDict();
 }
 
 // Определение функции для создания JSON-ответа с данными маршрута
-json::Node JsonReader::CreateRouteResponse(int id, const transport::BusStat& route_info) const {
-    json::Builder builder;
-    return builder.StartDict()
-        .Key("request_id").Value(id)
+void JsonReader::CreateRouteResponse(int id, const transport::BusStat& route_info, json::StreamBuilder& builder) const {
+    builder.StartDict()
         .Key("curvature").Value(route_info.curvature)
+        .Key("request_id").Value(id)
         .Key("route_length").Value(route_info.route_length)
         .Key("stop_count").Value(static_cast<int>(route_info.stops_count))
         .Key("unique_stop_count").Value(static_cast<int>(route_info.unique_stops_count))
-    .EndDict()
-    .Build();
+    .EndDict();
 }
 
 // Формирует JSON-ответ с информацией о маршруте на основе запроса
-const json::Node JsonReader::PrintRoute(const json::Dict& request_map, RequestHandler& rh) const {
+void JsonReader::PrintRoute(const json::Dict& request_map, RequestHandler& rh, json::StreamBuilder& builder) const {
     auto id_it = request_map.find("id");
     auto name_it = request_map.find("name");
 
     int id = (id_it != request_map.end()) ? id_it->second.AsInt() : 0;
-    const std::string& route_number = (name_it != request_map.end()) ? name_it->second.AsString() : "";
+    const std::string_view route_number = (name_it != request_map.end()) ? name_it->second.AsString() : ""sv;
 
     if (!rh.IsBusNumber(route_number)) {
-        return CreateErrorResponse(id, "not found");
+        CreateErrorResponse(id, "not found", builder);
     } else {
         const auto& route_info = rh.GetBusStat(route_number);
-        return CreateRouteResponse(id, *route_info);
+        CreateRouteResponse(id, *route_info, builder);
     }
 }
 
 // Формирует JSON-ответ с информацией о остановке на основе запроса
-const json::Node JsonReader::PrintStop(const json::Dict& request_map, RequestHandler& rh) const {
+void JsonReader::PrintStop(const json::Dict& request_map, RequestHandler& rh, json::StreamBuilder& builder) const {
     auto id_it = request_map.find("id");
     auto name_it = request_map.find("name");
 
     int id = (id_it != request_map.end()) ? id_it->second.AsInt() : 0;
-    const std::string& stop_name = (name_it != request_map.end()) ? name_it->second.AsString() : "";
+    const std::string_view stop_name = (name_it != request_map.end()) ? name_it->second.AsString() : ""sv;
 
-    json::Builder builder;
     if (!rh.IsStopName(stop_name)) {
-        return CreateErrorResponse(id, "not found");
+        CreateErrorResponse(id, "not found", builder);
     } else {
-        json::Array buses;
-        for (const auto& bus : rh.GetBusesByStop(stop_name)) {
-            buses.push_back(bus);
+        const auto bus_ids = rh.GetBusesByStop(stop_name);
+        auto buses = builder.StartDict().Key("buses").StartArray();
+        for (const uint32_t bus_id : bus_ids) {
+            buses.Value(rh.GetBusNumber(bus_id));
         }
-        return builder.StartDict()
+        buses.EndArray()
             .Key("request_id").Value(id)
-            .Key("buses").Value(buses)
-        .EndDict()
-        .Build();
+        .EndDict();
     }
 }
 
 // Формирует JSON-ответ с картой на основе запроса
-const json::Node JsonReader::PrintMap(const json::Dict& request_map, RequestHandler& rh) const {
+void JsonReader::PrintMap(const json::Dict& request_map, RequestHandler& rh, json::StreamBuilder& builder) const {
     auto id_it = request_map.find("id");
     int id = (id_it != request_map.end()) ? id_it->second.AsInt() : 0;
+    const std::string& map = rh.GetMapSvg();
 
-    std::ostringstream strm;
-    svg::Document map = rh.RenderMap();
-    map.Render(strm);
-
-    return json::Builder{}
-        .StartDict()
-            .Key("request_id").Value(id)
-            .Key("map").Value(strm.str())
-        .EndDict()
-        .Build();
+    builder.StartDict()
+        .Key("map").Value(map)
+        .Key("request_id").Value(id)
+    .EndDict();
 }
 
 // Формирует JSON-ответ с информацией о маршруте между двумя остановками на основе запроса
-const json::Node JsonReader::PrintRouting(const json::Dict& request_map, RequestHandler& rh) const {
-    json::Node result;
-
+void JsonReader::PrintRouting(const json::Dict& request_map, RequestHandler& rh, json::StreamBuilder& builder) const {
     auto id_it = request_map.find("id"s);
     auto from_it = request_map.find("from"s);
     auto to_it = request_map.find("to"s);
 
     if (id_it == request_map.end() || from_it == request_map.end() || to_it == request_map.end()) {
-        result = json::Builder{}
-            .StartDict()
-                .Key("error_message"s).Value("Invalid request format"s)
-            .EndDict()
-        .Build();
-        return result;
+        CreateInvalidFormatResponse(GetRequestId(request_map), builder);
+        return;
     }
 
     const int id = id_it->second.AsInt();
@@ -328,53 +432,126 @@ const json::Node JsonReader::PrintRouting(const json::Dict& request_map, Request
     const auto& routing = rh.GetOptimalRoute(stop_from, stop_to);
 
     if (!routing) {
-        result = json::Builder{}
-            .StartDict()
-                .Key("request_id"s).Value(id)
-                .Key("error_message"s).Value("not found"s)
-            .EndDict()
-        .Build();
+        CreateErrorResponse(id, "not found", builder);
+        return;
     }
-    else {
-        json::Array items;
-        double total_time = 0.0;
-        items.reserve(routing.value().edges.size());
-        for (auto& edge_id : routing.value().edges) {
-            const graph::Edge<double> edge = rh.GetRouterGraph().GetEdge(edge_id);
-            if (edge.quality == 0) {
-                items.emplace_back(json::Node(json::Builder{}
-                    .StartDict()
-                        .Key("stop_name"s).Value(edge.name)
-                        .Key("time"s).Value(edge.weight)
-                        .Key("type"s).Value("Wait"s)
-                    .EndDict()
-                .Build()));
-
-                total_time += edge.weight;
-            }
-            else {
-                items.emplace_back(json::Node(json::Builder{}
-                    .StartDict()
-                        .Key("bus"s).Value(edge.name)
-                        .Key("span_count"s).Value(static_cast<int>(edge.quality))
-                        .Key("time"s).Value(edge.weight)
-                        .Key("type"s).Value("Bus"s)
-                    .EndDict()
-                .Build()));
-
-                total_time += edge.weight;
-            }
+
+    // Общее время накапливается при выводе элементов: ключ total_time идёт после items
+    double total_time = 0.0;
+    auto items = builder.StartDict().Key("items"s).StartArray();
+    for (auto& edge_id : routing.value().edges) {
+        const graph::Edge<double> edge = rh.GetRouterGraph().GetEdge(edge_id);
+        if (rh.IsWalkEdge(edge_id)) {
+            items.StartDict()
+                .Key("stop_name"s).Value(edge.name)
+                .Key("time"s).Value(edge.weight)
+                .Key("type"s).Value("Walk"s)
+            .EndDict();
+        }
+        else if (edge.quality == 0) {
+            items.StartDict()
+                .Key("stop_name"s).Value(edge.name)
+                .Key("time"s).Value(edge.weight)
+                .Key("type"s).Value("Wait"s)
+            .EndDict();
         }
+        else {
+            items.StartDict()
+                .Key("bus"s).Value(edge.name)
+                .Key("span_count"s).Value(static_cast<int>(edge.quality))
+                .Key("time"s).Value(edge.weight)
+                .Key("type"s).Value("Bus"s)
+            .EndDict();
+        }
+        total_time += edge.weight;
+    }
+    items.EndArray()
+        .Key("request_id"s).Value(id)
+        .Key("total_time"s).Value(total_time)
+    .EndDict();
+}
 
-        result = json::Builder{}
-            .StartDict()
-                .Key("request_id"s).Value(id)
-                .Key("total_time"s).Value(total_time)
-                .Key("items"s).Value(items)
-            .EndDict()
-        .Build();
+// Формирует JSON-ответ со списком остановок рядом с точкой.
+// Запрос содержит latitude, longitude и хотя бы одно из полей radius (в метрах) и count
+void JsonReader::PrintNearbyStops(const json::Dict& request_map, RequestHandler& rh, json::StreamBuilder& builder) const {
+    auto id_it = request_map.find("id"s);
+    auto lat_it = request_map.find("latitude"s);
+    auto lng_it = request_map.find("longitude"s);
+    auto radius_it = request_map.find("radius"s);
+    auto count_it = request_map.find("count"s);
+
+    if (id_it == request_map.end() || lat_it == request_map.end() || lng_it == request_map.end()
+        || (radius_it == request_map.end() && count_it == request_map.end())) {
+        CreateInvalidFormatResponse(GetRequestId(request_map), builder);
+        return;
     }
 
-    return result;
+    const int id = id_it->second.AsInt();
+    const geo::Coordinates center = { lat_it->second.AsDouble(), lng_it->second.AsDouble() };
+    std::optional<double> radius;
+    if (radius_it != request_map.end()) {
+        radius = radius_it->second.AsDouble();
+    }
+    std::optional<size_t> count;
+    if (count_it != request_map.end()) {
+        count = static_cast<size_t>(std::max(count_it->second.AsInt(), 0));
+    }
+
+    const auto nearby_stops = rh.GetNearbyStops(center, radius, count);
+
+    auto stops = builder.StartDict()
+        .Key("request_id"s).Value(id)
+        .Key("stops"s).StartArray();
+    for (const auto& [stop, distance] : nearby_stops) {
+        stops.StartDict()
+            .Key("distance"s).Value(distance)
+            .Key("name"s).Value(stop->name)
+        .EndDict();
+    }
+    stops.EndArray().EndDict();
 }
 
+// Обработка запроса поиска остановок (StopSearch) или маршрутов (BusSearch) по началу имени
+void JsonReader::PrintNameSearch(const json::Dict& request_map, RequestHandler& rh, bool search_buses, json::StreamBuilder& builder) const {
+    static constexpr int DEFAULT_SEARCH_LIMIT = 10;
+
+    auto id_it = request_map.find("id"s);
+    auto query_it = request_map.find("query"s);
+    auto limit_it = request_map.find("limit"s);
+    auto distance_it = request_map.find("max_distance"s);
+
+    const int limit = limit_it != request_map.end() ? limit_it->second.AsInt() : DEFAULT_SEARCH_LIMIT;
+    const int max_distance = distance_it != request_map.end() ? distance_it->second.AsInt() : 0;
+    if (id_it == request_map.end() || query_it == request_map.end() || limit < 0
+        || max_distance < 0 || max_distance > transport::NameSearchIndex::MAX_DISTANCE) {
+        CreateInvalidFormatResponse(GetRequestId(request_map), builder);
+        return;
+    }
+
+    const int id = id_it->second.AsInt();
+    const std::string_view query = query_it->second.AsString();
+    auto add_item = [&builder](std::string_view name, int distance) {
+        builder.StartDict()
+            .Key("edit_distance"s).Value(distance)
+            .Key("name"s).Value(name)
+        .EndDict();
+    };
+
+    // Ключ buses идёт до request_id, а stops - после
+    if (search_buses) {
+        const auto buses = rh.SearchBuses(query, limit, max_distance);
+        builder.StartDict().Key("buses"s).StartArray();
+        for (const auto& [bus, distance] : buses) {
+            add_item(bus->number, distance);
+        }
+        builder.EndArray().Key("request_id"s).Value(id);
+    } else {
+        const auto stops = rh.SearchStops(query, limit, max_distance);
+        builder.StartDict().Key("request_id"s).Value(id).Key("stops"s).StartArray();
+        for (const auto& [stop, distance] : stops) {
+            add_item(stop->name, distance);
+        }
+        builder.EndArray();
+    }
+    builder.EndDict();
+}
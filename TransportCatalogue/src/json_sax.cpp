@@ -0,0 +1,513 @@
+#include "json_sax.h"
+#include "json_structural.h"
+
+#include <cctype>
+#include <charconv>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace json {
+
+namespace {
+using namespace std::literals;
+
+// Наибольшее количество цифр целого, которое всегда помещается в int
+constexpr ptrdiff_t MAX_SHORT_INT_DIGITS = 9;
+
+// Разбор буфера с явным стеком открытых массивов и словарей
+class Parser {
+public:
+    Parser(std::string_view text, Handler& handler)
+        : text_(text)
+        , handler_(handler)
+        , scanner_(text) {
+    }
+
+    void Run() {
+        ParseValue();
+        while (!stack_.empty()) {
+            if (stack_.back() == Container::ARRAY ? NextArrayItem() : NextDictItem()) {
+                ParseValue();
+            }
+        }
+    }
+
+    // Разбирает элементы массива без скобок до конца буфера: внешний массив считается открытым
+    void RunItems() {
+        stack_.push_back(Container::ARRAY);
+        while (true) {
+            if (stack_.size() > 1) {
+                if (stack_.back() == Container::ARRAY ? NextArrayItem() : NextDictItem()) {
+                    ParseValue();
+                }
+                continue;
+            }
+            char c;
+            if (!NextNonSpace(c)) {
+                return;
+            }
+            if (c != ',') {
+                --pos_;
+            }
+            ParseValue();
+        }
+    }
+
+private:
+    enum class Container : char { ARRAY, DICT };
+
+    static bool IsSpace(char c) {
+        return std::isspace(static_cast<unsigned char>(c));
+    }
+
+    static bool IsDigit(char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+    }
+
+    bool AtEnd() const {
+        return pos_ == text_.size();
+    }
+
+    // Возвращает следующий непробельный символ; false, если буфер закончился.
+    // Одиночный пробел пропускается сразу, серия пробелов - переходом к следующей позиции первого этапа
+    bool NextNonSpace(char& c) {
+        if (!AtEnd() && IsSpace(text_[pos_])) {
+            ++pos_;
+            if (!AtEnd() && IsSpace(text_[pos_])) {
+                pos_ = scanner_.NextToken(pos_);
+            }
+        }
+        if (AtEnd()) {
+            return false;
+        }
+        c = text_[pos_++];
+        return true;
+    }
+
+    // Разбирает значение; массивы и словари только открываются, их элементы разбирает Run
+    void ParseValue() {
+        char c;
+        if (!NextNonSpace(c)) {
+            throw ParsingError("Unexpected EOF"s);
+        }
+        switch (c) {
+            case '[':
+                handler_.StartArray();
+                stack_.push_back(Container::ARRAY);
+                break;
+            case '{':
+                handler_.StartObject();
+                stack_.push_back(Container::DICT);
+                break;
+            case '"':
+                handler_.String(ParseString());
+                break;
+            case 't':
+                [[fallthrough]];
+            case 'f':
+                --pos_;
+                ParseBool();
+                break;
+            case 'n':
+                --pos_;
+                ParseNull();
+                break;
+            default:
+                --pos_;
+                ParseNumber();
+                break;
+        }
+    }
+
+    // Переходит к следующему элементу массива; возвращает false, если массив закончился
+    bool NextArrayItem() {
+        char c;
+        if (!NextNonSpace(c)) {
+            throw ParsingError("Array parsing error"s);
+        }
+        if (c == ']') {
+            stack_.pop_back();
+            handler_.EndArray();
+            return false;
+        }
+        if (c != ',') {
+            --pos_;
+        }
+        return true;
+    }
+
+    // Переходит к значению следующей пары словаря; возвращает false, если словарь закончился
+    bool NextDictItem() {
+        for (char c;;) {
+            if (!NextNonSpace(c)) {
+                throw ParsingError("Dictionary parsing error"s);
+            }
+            if (c == '}') {
+                stack_.pop_back();
+                handler_.EndObject();
+                return false;
+            }
+            if (c == '"') {
+                handler_.Key(ParseString());
+                if (!NextNonSpace(c)) {
+                    throw ParsingError("Dictionary parsing error"s);
+                }
+                if (c != ':') {
+                    throw ParsingError(": is expected but '"s + c + "' has been found"s);
+                }
+                return true;
+            }
+            if (c != ',') {
+                throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
+            }
+        }
+    }
+
+    // Разбирает строку после открывающей кавычки. Строка без экранирования возвращается
+    // как часть буфера, иначе раскодируется во внутренний буфер разборщика
+    std::string_view ParseString() {
+        const size_t begin = pos_;
+
+        // Внутри строки первый этап не отмечает ничего, кроме закрывающей кавычки
+        const size_t end = scanner_.NextToken(begin);
+        if (end < text_.size() && text_[end] == '"' && !scanner_.HasStringSpecial(begin, end)) {
+            pos_ = end + 1;
+            return text_.substr(begin, end - begin);
+        }
+
+        // Строка с экранированием или ошибкой разбирается побайтно
+        while (!AtEnd()) {
+            const char c = text_[pos_];
+            if (c == '"') {
+                ++pos_;
+                return text_.substr(begin, pos_ - 1 - begin);
+            }
+            if (c == '\\') {
+                break;
+            }
+            if (c == '\n' || c == '\r') {
+                throw ParsingError("Unexpected end of line"s);
+            }
+            ++pos_;
+        }
+
+        scratch_.assign(text_.data() + begin, pos_ - begin);
+        while (true) {
+            if (AtEnd()) {
+                throw ParsingError("String parsing error");
+            }
+            const char c = text_[pos_++];
+            if (c == '"') {
+                break;
+            } else if (c == '\\') {
+                if (AtEnd()) {
+                    throw ParsingError("String parsing error");
+                }
+                const char escaped_char = text_[pos_++];
+                switch (escaped_char) {
+                    case 'n':
+                        scratch_.push_back('\n');
+                        break;
+                    case 't':
+                        scratch_.push_back('\t');
+                        break;
+                    case 'r':
+                        scratch_.push_back('\r');
+                        break;
+                    case '"':
+                        scratch_.push_back('"');
+                        break;
+                    case '\\':
+                        scratch_.push_back('\\');
+                        break;
+                    default:
+                        throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
+                }
+            } else if (c == '\n' || c == '\r') {
+                throw ParsingError("Unexpected end of line"s);
+            } else {
+                scratch_.push_back(c);
+            }
+        }
+        return scratch_;
+    }
+
+    std::string_view ParseLiteral() {
+        const size_t begin = pos_;
+        while (!AtEnd() && std::isalpha(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+        return text_.substr(begin, pos_ - begin);
+    }
+
+    void ParseBool() {
+        const auto s = ParseLiteral();
+        if (s == "true"sv) {
+            handler_.Bool(true);
+        } else if (s == "false"sv) {
+            handler_.Bool(false);
+        } else {
+            throw ParsingError("Failed to parse '"s + std::string(s) + "' as bool"s);
+        }
+    }
+
+    void ParseNull() {
+        if (auto literal = ParseLiteral(); literal == "null"sv) {
+            handler_.Null();
+        } else {
+            throw ParsingError("Failed to parse '"s + std::string(literal) + "' as null"s);
+        }
+    }
+
+    void ParseNumber() {
+        const size_t begin = pos_;
+
+        // Считывает одну или более цифр
+        auto read_digits = [this] {
+            if (AtEnd() || !IsDigit(text_[pos_])) {
+                throw ParsingError("A digit is expected"s);
+            }
+            while (!AtEnd() && IsDigit(text_[pos_])) {
+                ++pos_;
+            }
+        };
+        auto peek = [this] {
+            return AtEnd() ? '\0' : text_[pos_];
+        };
+
+        if (peek() == '-') {
+            ++pos_;
+        }
+        // Парсим целую часть числа
+        if (peek() == '0') {
+            ++pos_;
+            // После 0 в JSON не могут идти другие цифры
+        } else {
+            read_digits();
+        }
+
+        bool is_int = true;
+        // Парсим дробную часть числа
+        if (peek() == '.') {
+            ++pos_;
+            read_digits();
+            is_int = false;
+        }
+
+        // Парсим экспоненциальную часть числа
+        if (char ch = peek(); ch == 'e' || ch == 'E') {
+            ++pos_;
+            if (ch = peek(); ch == '+' || ch == '-') {
+                ++pos_;
+            }
+            read_digits();
+            is_int = false;
+        }
+
+        const char* first = text_.data() + begin;
+        const char* last = text_.data() + pos_;
+        if (is_int) {
+            // Короткие целые (до 9 цифр) заведомо помещаются в int и собираются без from_chars
+            const bool negative = *first == '-';
+            const char* digits = negative ? first + 1 : first;
+            if (last - digits <= MAX_SHORT_INT_DIGITS) {
+                int value = 0;
+                for (const char* it = digits; it != last; ++it) {
+                    value = value * 10 + (*it - '0');
+                }
+                handler_.Int(negative ? -value : value);
+                return;
+            }
+            int value = 0;
+            if (std::from_chars(first, last, value).ec == std::errc{}) {
+                handler_.Int(value);
+                return;
+            }
+            // При переполнении int число разбирается как double
+        }
+        double value = 0.0;
+        if (std::from_chars(first, last, value).ec != std::errc{}) {
+            throw ParsingError("Failed to convert "s + std::string(first, last) + " to number"s);
+        }
+        handler_.Double(value);
+    }
+
+    std::string_view text_;
+    size_t pos_ = 0;
+    Handler& handler_;
+    StructuralScanner scanner_;     // Позиции элементов (первый этап разбора)
+    std::vector<Container> stack_;  // Открытые массивы и словари
+    std::string scratch_;           // Буфер для строк с экранированием
+};
+
+// Поиск значения ключа верхнего словаря по позициям первого этапа разбора, без событий
+class SectionFinder {
+public:
+    explicit SectionFinder(std::string_view text)
+        : text_(text)
+        , scanner_(text) {
+    }
+
+    // Позиция значения ключа key; nullopt, если такого ключа нет
+    std::optional<size_t> Find(std::string_view key) {
+        size_t pos = scanner_.NextToken(0);
+        if (pos == text_.size() || text_[pos] != '{') {
+            return std::nullopt;
+        }
+        pos = Next(pos + 1);
+        while (text_[pos] == '"') {
+            const size_t key_end = Next(pos + 1);
+            const std::string_view current_key = text_.substr(pos + 1, key_end - pos - 1);
+            const size_t colon = Next(key_end + 1);
+            if (text_[colon] != ':') {
+                throw ParsingError("Dict parsing error"s);
+            }
+            const size_t value = Next(colon + 1);
+            if (current_key == key) {
+                return value;
+            }
+            pos = Next(SkipValue(value));
+            if (text_[pos] != ',') {
+                break;
+            }
+            pos = Next(pos + 1);
+        }
+        return std::nullopt;
+    }
+
+private:
+    // Следующая позиция первого этапа не раньше pos; конец буфера - ошибка
+    size_t Next(size_t pos) {
+        const size_t token = scanner_.NextToken(pos);
+        if (token == text_.size()) {
+            throw ParsingError("Unexpected EOF"s);
+        }
+        return token;
+    }
+
+    // Возвращает позицию сразу за значением, начинающимся в pos
+    size_t SkipValue(size_t pos) {
+        if (text_[pos] == '"') {
+            return Next(pos + 1) + 1;
+        }
+        if (text_[pos] != '{' && text_[pos] != '[') {
+            // У числа и литерала позиция первого этапа есть только у первого символа
+            return pos + 1;
+        }
+        int depth = 1;
+        while (depth > 0) {
+            pos = Next(pos + 1);
+            switch (text_[pos]) {
+                case '{':
+                    [[fallthrough]];
+                case '[':
+                    ++depth;
+                    break;
+                case '}':
+                    [[fallthrough]];
+                case ']':
+                    --depth;
+                    break;
+                case '"':
+                    // Следующая позиция - закрывающая кавычка: содержимое строки пропускается
+                    pos = Next(pos + 1);
+                    break;
+                default:
+                    break;
+            }
+        }
+        return pos + 1;
+    }
+
+    std::string_view text_;
+    StructuralScanner scanner_;
+};
+
+// Границы участков для сводок: примерно равные доли text начиная с begin.
+// Граница сдвигается вперёд, пока перед ней стоит '\\', чтобы участок не начинался с экранированного символа
+std::vector<size_t> RangeBounds(std::string_view text, size_t begin, size_t count) {
+    std::vector<size_t> bounds{begin};
+    for (size_t i = 1; i < count; ++i) {
+        size_t bound = std::max(bounds.back(), begin + (text.size() - begin) / count * i);
+        while (bound < text.size() && text[bound - 1] == '\\') {
+            ++bound;
+        }
+        bounds.push_back(bound);
+    }
+    bounds.push_back(text.size());
+    return bounds;
+}
+
+} // namespace
+
+void Parse(std::string_view text, Handler& handler) {
+    Parser(text, handler).Run();
+}
+
+void Parse(std::istream& input, Handler& handler) {
+    const std::string text(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>{});
+    Parse(text, handler);
+}
+
+void ParseArrayItems(std::string_view text, Handler& handler) {
+    Parser(text, handler).RunItems();
+}
+
+std::optional<ArraySection> SplitArraySection(std::string_view text, std::string_view key, size_t parts, size_t threads) {
+    const std::optional<size_t> open = SectionFinder(text).Find(key);
+    if (!open || text[*open] != '[') {
+        return std::nullopt;
+    }
+
+    // Участки от начала массива до конца текста сводятся параллельно
+    threads = std::max<size_t>(threads, 1);
+    const std::vector<size_t> bounds = RangeBounds(text, *open + 1, std::max<size_t>(parts, 1));
+    const size_t ranges_count = bounds.size() - 1;
+    std::vector<RangeSummary> summaries(ranges_count);
+    {
+        std::vector<std::thread> workers;
+        for (size_t worker = 0; worker < std::min(threads, ranges_count); ++worker) {
+            workers.emplace_back([&, worker] {
+                for (size_t i = worker; i < ranges_count; i += threads) {
+                    summaries[i] = SummarizeRange(text.substr(bounds[i], bounds[i + 1] - bounds[i]));
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Последовательно по сводкам: состояние в начале участка, первая запятая между элементами в нём
+    // и участок, где массив закрывается. Вложенность считается от уровня элементов массива
+    ArraySection section{*open, 0, {}};
+    size_t part_begin = *open + 1;
+    bool in_string = false;
+    int depth = 0;
+    for (size_t i = 0; i < ranges_count; ++i) {
+        const std::string_view range = text.substr(bounds[i], bounds[i + 1] - bounds[i]);
+        const RangeSummary& summary = summaries[i];
+        const bool closes = depth + summary.min_depth[in_string] < 0;
+        if (i > 0) {
+            const size_t comma = bounds[i] + FindAtDepth(range, in_string, -depth, true);
+            if (comma < bounds[i + 1] && text[comma] == ',') {
+                section.parts.push_back(text.substr(part_begin, comma - part_begin));
+                part_begin = comma + 1;
+            }
+        }
+        if (closes) {
+            const size_t close = bounds[i] + FindAtDepth(range, in_string, -depth, false);
+            section.parts.push_back(text.substr(part_begin, close - part_begin));
+            section.end = close + 1;
+            return section;
+        }
+        depth += summary.depth_change[in_string];
+        in_string ^= summary.odd_quotes;
+    }
+    throw ParsingError("Unexpected EOF"s);
+}
+
+} // namespace json
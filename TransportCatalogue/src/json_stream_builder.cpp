@@ -0,0 +1,136 @@
+#include "json_stream_builder.h"
+
+#include <stdexcept>
+
+using namespace std::literals;
+
+namespace json {
+
+StreamBuilder::StreamBuilder(OutputBuffer& output, const PrintOptions& options)
+    : formatter_(output, options) {
+}
+
+void StreamBuilder::Finish() const {
+    if (!root_done_ || depth_ != 0) {
+        throw std::logic_error("Attempt to build JSON which isn't finalized"s);
+    }
+}
+
+void StreamBuilder::Reset() {
+    Finish();
+    root_done_ = false;
+}
+
+void StreamBuilder::Discard() {
+    depth_ = 0;
+    root_done_ = false;
+}
+
+StreamBuilder::KeyValueContext StreamBuilder::Key(std::string_view key) {
+    if (depth_ == 0 || !levels_[depth_ - 1].is_dict || levels_[depth_ - 1].has_key) {
+        throw std::logic_error("Key() outside a dict"s);
+    }
+    Level& level = levels_[depth_ - 1];
+    if (!level.first && key <= level.last_key) {
+        throw std::logic_error("Keys must be added in ascending order"s);
+    }
+    formatter_.BeginItem(level.first, formatter_.GetInnerIndent(level.indent));
+    formatter_.WriteKey(key);
+    level.first = false;
+    level.has_key = true;
+    level.last_key.assign(key);
+    return KeyValueContext(*this);
+}
+
+StreamBuilder::DictItemContext StreamBuilder::StartDict() {
+    PushLevel(/* is_dict */ true, BeginValue());
+    formatter_.OpenContainer('{');
+    return DictItemContext(*this);
+}
+
+StreamBuilder::ArrayItemContext StreamBuilder::StartArray() {
+    PushLevel(/* is_dict */ false, BeginValue());
+    formatter_.OpenContainer('[');
+    return ArrayItemContext(*this);
+}
+
+StreamBuilder& StreamBuilder::EndDict() {
+    if (depth_ == 0 || !levels_[depth_ - 1].is_dict || levels_[depth_ - 1].has_key) {
+        throw std::logic_error("EndDict() outside a dict"s);
+    }
+    formatter_.EndContainer('}', levels_[--depth_].indent);
+    return *this;
+}
+
+StreamBuilder& StreamBuilder::EndArray() {
+    if (depth_ == 0 || levels_[depth_ - 1].is_dict) {
+        throw std::logic_error("EndArray() outside an array"s);
+    }
+    formatter_.EndContainer(']', levels_[--depth_].indent);
+    return *this;
+}
+
+int StreamBuilder::BeginValue() {
+    if (depth_ == 0) {
+        if (root_done_) {
+            throw std::logic_error("Attempt to change finalized JSON"s);
+        }
+        root_done_ = true;
+        value_indent_ = 0;
+        return value_indent_;
+    }
+    Level& level = levels_[depth_ - 1];
+    value_indent_ = formatter_.GetInnerIndent(level.indent);
+    if (level.is_dict) {
+        // Значение словаря допустимо только после ключа; разделитель выведен вместе с ключом
+        if (!level.has_key) {
+            throw std::logic_error("New object in wrong context"s);
+        }
+        level.has_key = false;
+    } else {
+        formatter_.BeginItem(level.first, value_indent_);
+        level.first = false;
+    }
+    return value_indent_;
+}
+
+void StreamBuilder::PushLevel(bool is_dict, int indent) {
+    if (depth_ == levels_.size()) {
+        levels_.emplace_back();
+    }
+    Level& level = levels_[depth_++];
+    level.is_dict = is_dict;
+    level.first = true;
+    level.has_key = false;
+    level.indent = indent;
+}
+
+StreamBuilder::KeyValueContext StreamBuilder::DictItemContext::Key(std::string_view key) {
+    return builder_.Key(key);
+}
+
+StreamBuilder& StreamBuilder::DictItemContext::EndDict() {
+    return builder_.EndDict();
+}
+
+StreamBuilder::DictItemContext StreamBuilder::ArrayItemContext::StartDict() {
+    return builder_.StartDict();
+}
+
+StreamBuilder::ArrayItemContext StreamBuilder::ArrayItemContext::StartArray() {
+    return builder_.StartArray();
+}
+
+StreamBuilder& StreamBuilder::ArrayItemContext::EndArray() {
+    return builder_.EndArray();
+}
+
+StreamBuilder::DictItemContext StreamBuilder::KeyValueContext::StartDict() {
+    return builder_.StartDict();
+}
+
+StreamBuilder::ArrayItemContext StreamBuilder::KeyValueContext::StartArray() {
+    return builder_.StartArray();
+}
+
+} // namespace json
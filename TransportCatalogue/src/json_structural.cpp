@@ -0,0 +1,360 @@
+#include "json_structural.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define JSON_USE_SSE2
+#endif
+
+#if defined(JSON_USE_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define JSON_USE_AVX2
+#endif
+
+namespace json {
+
+namespace {
+
+// Размер части буфера, просматриваемой за один раз
+constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+constexpr uint64_t ODD_BITS = 0xAAAAAAAAAAAAAAAAULL;
+
+// Битовые маски символов блока из 64 байт
+struct BlockMasks {
+    uint64_t quote = 0;       // "
+    uint64_t backslash = 0;   // обратная косая черта
+    uint64_t whitespace = 0;  // пробельные символы (как std::isspace)
+    uint64_t op = 0;          // { } [ ] : ,
+    uint64_t line_end = 0;    // \n и \r
+    // Заполняются только классификаторами с BRACKETS = true (для SummarizeRange и FindAtDepth),
+    // чтобы не замедлять основной разбор
+    uint64_t open = 0;        // { [
+    uint64_t close = 0;       // } ]
+    uint64_t comma = 0;       // ,
+};
+
+template <bool BRACKETS>
+void ClassifyScalar(const char* block, BlockMasks& masks) {
+    for (int i = 0; i < 64; ++i) {
+        const uint64_t bit = uint64_t{1} << i;
+        switch (block[i]) {
+            case '"':
+                masks.quote |= bit;
+                break;
+            case '\\':
+                masks.backslash |= bit;
+                break;
+            case '\n':
+            case '\r':
+                masks.line_end |= bit;
+                [[fallthrough]];
+            case ' ':
+            case '\t':
+            case '\v':
+            case '\f':
+                masks.whitespace |= bit;
+                break;
+            case '{':
+            case '[':
+                masks.op |= bit;
+                if constexpr (BRACKETS) {
+                    masks.open |= bit;
+                }
+                break;
+            case '}':
+            case ']':
+                masks.op |= bit;
+                if constexpr (BRACKETS) {
+                    masks.close |= bit;
+                }
+                break;
+            case ',':
+                masks.op |= bit;
+                if constexpr (BRACKETS) {
+                    masks.comma |= bit;
+                }
+                break;
+            case ':':
+                masks.op |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+#ifdef JSON_USE_SSE2
+template <bool BRACKETS>
+void ClassifySse2(const char* block, BlockMasks& masks) {
+    auto eq = [](__m128i chunk, char c) {
+        return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c));
+    };
+    for (int part = 0; part < 4; ++part) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + part * 16));
+        const __m128i line_end = _mm_or_si128(eq(chunk, '\n'), eq(chunk, '\r'));
+        const __m128i whitespace = _mm_or_si128(_mm_or_si128(line_end, eq(chunk, ' ')),
+            _mm_or_si128(eq(chunk, '\t'), _mm_or_si128(eq(chunk, '\v'), eq(chunk, '\f'))));
+        // Скобки отличаются от своих пар только битом 0x20: '[' 0x5B и '{' 0x7B, ']' 0x5D и '}' 0x7D
+        const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        const __m128i open = eq(folded, '{');
+        const __m128i close = eq(folded, '}');
+        const __m128i comma = eq(chunk, ',');
+        const __m128i op = _mm_or_si128(_mm_or_si128(open, close), _mm_or_si128(eq(chunk, ':'), comma));
+        const int shift = part * 16;
+        masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(eq(chunk, '"')))) << shift;
+        masks.backslash |= uint64_t(uint16_t(_mm_movemask_epi8(eq(chunk, '\\')))) << shift;
+        masks.whitespace |= uint64_t(uint16_t(_mm_movemask_epi8(whitespace))) << shift;
+        masks.op |= uint64_t(uint16_t(_mm_movemask_epi8(op))) << shift;
+        masks.line_end |= uint64_t(uint16_t(_mm_movemask_epi8(line_end))) << shift;
+        if constexpr (BRACKETS) {
+            masks.open |= uint64_t(uint16_t(_mm_movemask_epi8(open))) << shift;
+            masks.close |= uint64_t(uint16_t(_mm_movemask_epi8(close))) << shift;
+            masks.comma |= uint64_t(uint16_t(_mm_movemask_epi8(comma))) << shift;
+        }
+    }
+}
+#endif
+
+#ifdef JSON_USE_AVX2
+template <bool BRACKETS>
+__attribute__((target("avx2"))) void ClassifyAvx2(const char* block, BlockMasks& masks) {
+    // Сравнения записаны без вспомогательной лямбды: возврат __m256i из функции
+    // без target("avx2") меняет ABI
+#define JSON_EQ(chunk, c) _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c))
+    for (int part = 0; part < 2; ++part) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + part * 32));
+        const __m256i line_end = _mm256_or_si256(JSON_EQ(chunk, '\n'), JSON_EQ(chunk, '\r'));
+        const __m256i whitespace = _mm256_or_si256(_mm256_or_si256(line_end, JSON_EQ(chunk, ' ')),
+            _mm256_or_si256(JSON_EQ(chunk, '\t'), _mm256_or_si256(JSON_EQ(chunk, '\v'), JSON_EQ(chunk, '\f'))));
+        const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+        const __m256i open = JSON_EQ(folded, '{');
+        const __m256i close = JSON_EQ(folded, '}');
+        const __m256i comma = JSON_EQ(chunk, ',');
+        const __m256i op = _mm256_or_si256(_mm256_or_si256(open, close), _mm256_or_si256(JSON_EQ(chunk, ':'), comma));
+        const int shift = part * 32;
+        masks.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(JSON_EQ(chunk, '"')))) << shift;
+        masks.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(JSON_EQ(chunk, '\\')))) << shift;
+        masks.whitespace |= uint64_t(uint32_t(_mm256_movemask_epi8(whitespace))) << shift;
+        masks.op |= uint64_t(uint32_t(_mm256_movemask_epi8(op))) << shift;
+        masks.line_end |= uint64_t(uint32_t(_mm256_movemask_epi8(line_end))) << shift;
+        if constexpr (BRACKETS) {
+            masks.open |= uint64_t(uint32_t(_mm256_movemask_epi8(open))) << shift;
+            masks.close |= uint64_t(uint32_t(_mm256_movemask_epi8(close))) << shift;
+            masks.comma |= uint64_t(uint32_t(_mm256_movemask_epi8(comma))) << shift;
+        }
+    }
+#undef JSON_EQ
+}
+#endif
+
+using ClassifyFunction = void (*)(const char*, BlockMasks&);
+
+// Выбирает самую широкую доступную реализацию один раз за время работы программы
+template <bool BRACKETS>
+ClassifyFunction SelectClassify() {
+#ifdef JSON_USE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return ClassifyAvx2<BRACKETS>;
+    }
+#endif
+#ifdef JSON_USE_SSE2
+    return ClassifySse2<BRACKETS>;
+#else
+    return ClassifyScalar<BRACKETS>;
+#endif
+}
+
+const ClassifyFunction CLASSIFY = SelectClassify<false>();
+const ClassifyFunction CLASSIFY_BRACKETS = SelectClassify<true>();
+
+// Префиксный XOR: бит i результата - чётность количества единиц в битах 0..i
+uint64_t PrefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// Символы, экранированные обратной косой чертой: после серии черт нечётной длины.
+// Вычитание выделяет серии, начинающиеся на чётных и нечётных позициях, без цикла по битам
+uint64_t FindEscaped(uint64_t backslash, uint64_t& next_is_escaped) {
+    if (backslash == 0) {
+        const uint64_t escaped = next_is_escaped;
+        next_is_escaped = 0;
+        return escaped;
+    }
+    // Черта, которая сама экранирована, не начинает новую серию
+    const uint64_t potential_escape = backslash & ~next_is_escaped;
+    const uint64_t maybe_escaped = potential_escape << 1;
+    const uint64_t escape_and_terminal_code = ((maybe_escaped | ODD_BITS) - potential_escape) ^ ODD_BITS;
+    const uint64_t escaped = escape_and_terminal_code ^ (backslash | next_is_escaped);
+    const uint64_t escape = escape_and_terminal_code & backslash;
+    next_is_escaped = escape >> 63;
+    return escaped;
+}
+
+// Обходит блоки text с начала, передавая f(смещение блока, маски блока, маску строк).
+// in_string_carry - все единицы, если text начинается внутри строки. Обход прекращается,
+// когда f возвращает false
+template <typename Function>
+void ForEachBlock(std::string_view text, uint64_t in_string_carry, Function f) {
+    uint64_t next_is_escaped = 0;
+    for (size_t offset = 0; offset < text.size(); offset += 64) {
+        BlockMasks masks;
+        if (offset + 64 <= text.size()) {
+            CLASSIFY_BRACKETS(text.data() + offset, masks);
+        } else {
+            char block[64];
+            std::memset(block, ' ', sizeof(block));
+            std::memcpy(block, text.data() + offset, text.size() - offset);
+            CLASSIFY_BRACKETS(block, masks);
+        }
+        masks.quote &= ~FindEscaped(masks.backslash, next_is_escaped);
+        const uint64_t in_string = PrefixXor(masks.quote) ^ in_string_carry;
+        in_string_carry = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+        if (!f(offset, masks, in_string)) {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+RangeSummary SummarizeRange(std::string_view text) {
+    RangeSummary summary;
+    int depth[2] = {0, 0};
+    ForEachBlock(text, 0, [&](size_t, const BlockMasks& masks, uint64_t in_string) {
+        summary.odd_quotes ^= __builtin_popcountll(masks.quote) & 1;
+        // Если участок начинается внутри строки, маска строк инвертирована
+        const uint64_t outside[2] = {~in_string, in_string};
+        for (int i = 0; i < 2; ++i) {
+            const uint64_t open = masks.open & outside[i];
+            const uint64_t close = masks.close & outside[i];
+            if (close == 0) {
+                // Без закрывающих скобок наименьшая вложенность не меняется
+                depth[i] += __builtin_popcountll(open);
+                continue;
+            }
+            for (uint64_t brackets = open | close; brackets != 0; brackets &= brackets - 1) {
+                depth[i] += (open & brackets & -brackets) != 0 ? 1 : -1;
+                summary.min_depth[i] = std::min(summary.min_depth[i], depth[i]);
+            }
+        }
+        return true;
+    });
+    summary.depth_change[0] = depth[0];
+    summary.depth_change[1] = depth[1];
+    return summary;
+}
+
+size_t FindAtDepth(std::string_view text, bool in_string, int depth, bool commas) {
+    size_t result = text.size();
+    int current = 0;
+    ForEachBlock(text, in_string ? ~uint64_t{0} : 0, [&](size_t offset, const BlockMasks& masks, uint64_t in_string) {
+        const uint64_t open = masks.open & ~in_string;
+        const uint64_t close = masks.close & ~in_string;
+        const uint64_t comma = commas ? masks.comma & ~in_string : 0;
+        for (uint64_t marks = open | close | comma; marks != 0; marks &= marks - 1) {
+            const uint64_t bit = marks & -marks;
+            if ((open & bit) != 0) {
+                ++current;
+                continue;
+            }
+            if (current == depth) {
+                result = offset + __builtin_ctzll(bit);
+                return false;
+            }
+            if ((close & bit) != 0) {
+                --current;
+            }
+        }
+        return true;
+    });
+    return result;
+}
+
+StructuralScanner::StructuralScanner(std::string_view text)
+    : text_(text) {
+}
+
+size_t StructuralScanner::FindNextToken(size_t pos) {
+    size_t block = pos / 64;
+    uint64_t from_pos = ~uint64_t{0} << (pos % 64);
+    while (true) {
+        if (block >= first_block_ + token_masks_.size()) {
+            if (scanned_ >= text_.size()) {
+                return text_.size();
+            }
+            ScanChunk(pos);
+            continue;
+        }
+        const uint64_t mask = token_masks_[block - first_block_] & from_pos;
+        if (mask != 0) {
+            return block * 64 + __builtin_ctzll(mask);
+        }
+        ++block;
+        from_pos = ~uint64_t{0};
+    }
+}
+
+bool StructuralScanner::HasSpecialInBlocks(size_t begin, size_t end) const {
+    for (size_t block = begin / 64; block * 64 < end; ++block) {
+        uint64_t mask = special_masks_[block - first_block_];
+        if (block == begin / 64) {
+            mask &= ~uint64_t{0} << (begin % 64);
+        }
+        if (end - block * 64 < 64) {
+            mask &= (uint64_t{1} << (end - block * 64)) - 1;
+        }
+        if (mask != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StructuralScanner::ScanChunk(size_t pos) {
+    // Блоки до блока позиции pos больше не понадобятся
+    const size_t keep_from = std::min(pos / 64, first_block_ + token_masks_.size());
+    token_masks_.erase(token_masks_.begin(), token_masks_.begin() + (keep_from - first_block_));
+    special_masks_.erase(special_masks_.begin(), special_masks_.begin() + (keep_from - first_block_));
+    first_block_ = keep_from;
+
+    const size_t chunk_end = std::min(text_.size(), scanned_ + CHUNK_SIZE);
+    for (; scanned_ < chunk_end; scanned_ += 64) {
+        BlockMasks masks;
+        if (scanned_ + 64 <= text_.size()) {
+            CLASSIFY(text_.data() + scanned_, masks);
+        } else {
+            // Неполный последний блок дополняется пробелами
+            char block[64];
+            std::memset(block, ' ', sizeof(block));
+            std::memcpy(block, text_.data() + scanned_, text_.size() - scanned_);
+            CLASSIFY(block, masks);
+        }
+
+        const uint64_t escaped = FindEscaped(masks.backslash, next_is_escaped_);
+        const uint64_t quote = masks.quote & ~escaped;
+
+        // Бит строки установлен от открывающей кавычки включительно до закрывающей исключительно
+        const uint64_t in_string = PrefixXor(quote) ^ in_string_;
+        in_string_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+        const uint64_t separator = masks.whitespace | masks.op;
+        const uint64_t follows_separator = (separator << 1) | follows_separator_;
+        follows_separator_ = separator >> 63;
+
+        const uint64_t scalar = ~(separator | quote | in_string);
+        token_masks_.push_back(((masks.op | (scalar & follows_separator)) & ~in_string) | quote);
+        special_masks_.push_back((masks.backslash | masks.line_end) & in_string);
+    }
+    scanned_ = std::min(scanned_, text_.size());
+}
+
+} // namespace json
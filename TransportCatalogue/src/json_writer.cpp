@@ -0,0 +1,207 @@
+#include "json_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
+namespace json {
+
+namespace {
+using namespace std::literals;
+
+// Замена символа при экранировании; 0 - символ выводится как есть.
+// Символы " и \ выводятся как \" и \\, переводы строк и табуляция - как \r, \n, \t
+constexpr std::array<char, 256> MakeEscapeTable() {
+    std::array<char, 256> table{};
+    table[static_cast<unsigned char>('"')] = '"';
+    table[static_cast<unsigned char>('\\')] = '\\';
+    table[static_cast<unsigned char>('\r')] = 'r';
+    table[static_cast<unsigned char>('\n')] = 'n';
+    table[static_cast<unsigned char>('\t')] = 't';
+    return table;
+}
+
+constexpr std::array<char, 256> ESCAPE_TABLE = MakeEscapeTable();
+
+// Записывает size байт в дескриптор fd, повторяя частичные записи
+void WriteToFd(int fd, const char* data, size_t size) {
+    while (size > 0) {
+#if defined(_WIN32)
+        const int written = ::_write(fd, data, static_cast<unsigned int>(size));
+#else
+        const ssize_t written = ::write(fd, data, size);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("write failed: "s + std::strerror(errno));
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+} // namespace
+
+OutputBuffer::OutputBuffer(std::ostream& output)
+    : stream_(&output) {
+    data_.reserve(FLUSH_SIZE);
+}
+
+OutputBuffer::OutputBuffer(int fd)
+    : fd_(fd) {
+    data_.reserve(FLUSH_SIZE);
+}
+
+OutputBuffer::~OutputBuffer() {
+    try {
+        Flush();
+    } catch (...) {
+    }
+}
+
+void OutputBuffer::Flush() {
+    if (data_.empty()) {
+        return;
+    }
+    if (stream_ != nullptr) {
+        stream_->write(data_.data(), static_cast<std::streamsize>(data_.size()));
+    } else {
+        WriteToFd(fd_, data_.data(), data_.size());
+    }
+    flushed_ += data_.size();
+    data_.clear();
+}
+
+bool OutputBuffer::Truncate(size_t position) {
+    if (position < flushed_) {
+        return false;
+    }
+    data_.resize(std::min(data_.size(), position - flushed_));
+    return true;
+}
+
+void Formatter::OpenContainer(char bracket) {
+    output_.Put(bracket);
+    if (options_.pretty) {
+        output_.Put('\n');
+    }
+}
+
+// Разделитель перед элементом (кроме первого) и отступ
+void Formatter::BeginItem(bool first, int indent) {
+    if (!first) {
+        output_.Put(',');
+    }
+    if (options_.pretty) {
+        if (!first) {
+            output_.Put('\n');
+        }
+        output_.Fill(' ', indent);
+    }
+}
+
+// Перевод строки, отступ и закрывающая скобка
+void Formatter::EndContainer(char bracket, int indent) {
+    if (options_.pretty) {
+        output_.Put('\n');
+        output_.Fill(' ', indent);
+    }
+    output_.Put(bracket);
+}
+
+void Formatter::WriteKey(std::string_view key) {
+    WriteString(key);
+    output_.Write(options_.pretty ? ": "sv : ":"sv);
+}
+
+void Formatter::WriteString(std::string_view text) {
+    output_.Put('"');
+    size_t run_begin = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char escape = ESCAPE_TABLE[static_cast<unsigned char>(text[i])];
+        if (escape != 0) {
+            output_.Write(text.substr(run_begin, i - run_begin));
+            output_.Put('\\');
+            output_.Put(escape);
+            run_begin = i + 1;
+        }
+    }
+    output_.Write(text.substr(run_begin));
+    output_.Put('"');
+}
+
+void Formatter::WriteInt(int value) {
+    char buffer[16];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    output_.Write(std::string_view(buffer, result.ptr - buffer));
+}
+
+void Formatter::WriteDouble(double value) {
+    // Формат по умолчанию совпадает с выводом double в std::ostream (%g, 6 цифр)
+    char buffer[32];
+    const auto result = options_.shortest_doubles
+        ? std::to_chars(buffer, buffer + sizeof(buffer), value)
+        : std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+    output_.Write(std::string_view(buffer, result.ptr - buffer));
+}
+
+void Formatter::WriteBool(bool value) {
+    output_.Write(value ? "true"sv : "false"sv);
+}
+
+void Formatter::WriteNull() {
+    output_.Write("null"sv);
+}
+
+void Formatter::WriteNode(const Node& node, int indent) {
+    const Node::Value& value = node.GetValue();
+    if (const auto* array = std::get_if<Array>(&value)) {
+        OpenContainer('[');
+        const int inner_indent = GetInnerIndent(indent);
+        bool first = true;
+        for (const Node& item : *array) {
+            BeginItem(first, inner_indent);
+            first = false;
+            WriteNode(item, inner_indent);
+        }
+        EndContainer(']', indent);
+    } else if (const auto* dict = std::get_if<Dict>(&value)) {
+        OpenContainer('{');
+        const int inner_indent = GetInnerIndent(indent);
+        bool first = true;
+        for (const auto& [key, item] : *dict) {
+            BeginItem(first, inner_indent);
+            first = false;
+            WriteKey(key);
+            WriteNode(item, inner_indent);
+        }
+        EndContainer('}', indent);
+    } else if (node.IsString()) {
+        WriteString(node.AsString());
+    } else if (const auto* number = std::get_if<int>(&value)) {
+        WriteInt(*number);
+    } else if (const auto* number = std::get_if<double>(&value)) {
+        WriteDouble(*number);
+    } else if (const auto* flag = std::get_if<bool>(&value)) {
+        WriteBool(*flag);
+    } else {
+        WriteNull();
+    }
+}
+
+void WriteNode(const Node& node, OutputBuffer& output, const PrintOptions& options) {
+    Formatter(output, options).WriteNode(node, 0);
+}
+
+} // namespace json
@@ -1,28 +1,84 @@
+#include "base_request_decoder.h"
+#include "geo_check.h"
+#include "json_benchmark.h"
 #include "json_reader.h"
 #include "request_handler.h"
+#include "snapshot.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <thread>
 
-int main() {
+namespace {
 
-    std::fstream input("input.json");
-    if (!input) { 
-        std::cerr << "Error: unable to open input file." << std::endl;
+// Выводит в stderr отчёты о занимаемой памяти после очередного этапа запуска
+void ReportMemory(bool enabled, const char* phase, std::initializer_list<memory::Usage> usages) {
+    if (!enabled) {
+        return;
+    }
+    std::cerr << "=== memory after " << phase << " ===\n";
+    for (const memory::Usage& usage : usages) {
+        memory::Print(usage, std::cerr);
     }
+}
+
+} // namespace
 
-    std::fstream output("output.xml");
-    if (!output) {
-        std::cerr << "Error: unable to open output file." << std::endl;
+int main(int argc, char* argv[]) {
+
+    // --memory-report: после каждого этапа запуска выводить в stderr разбивку занимаемой памяти
+    // --parse-benchmark FILE...: только замерить скорость разбора перечисленных JSON-файлов
+    // --distance-check: только сверить пакетное вычисление расстояний с эталонным
+    //                   (код возврата 1, если отклонение превышает допустимое)
+    // --ndjson: после загрузки базы из input.json принимать запросы из stdin по одному в строке
+    //           и отвечать на каждый отдельной строкой; stat_requests из input.json не обрабатываются
+    // --threads N: число потоков разбора base_requests и подсчёта статистики маршрутов
+    //              (по умолчанию - число ядер; 1 - без потоков)
+    bool memory_report = false;
+    bool ndjson = false;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--memory-report") == 0) {
+            memory_report = true;
+        } else if (std::strcmp(argv[i], "--ndjson") == 0) {
+            ndjson = true;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--parse-benchmark") == 0) {
+            try {
+                json::RunParseBenchmark(std::vector<std::string>(argv + i + 1, argv + argc), std::cout);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                return 1;
+            }
+            return 0;
+        } else if (std::strcmp(argv[i], "--distance-check") == 0) {
+            return geo::RunDistanceCheck(std::cout) ? 0 : 1;
+        }
     }
 
-    // Создание объекта JsonReader для загрузки и обработки JSON 
-    JsonReader json_doc(input);
-    input.close();
+    // Входной файл отображается в память; строки документа ссылаются прямо на него
+    std::shared_ptr<const json::InputBuffer> input;
+    try {
+        input = json::InputBuffer::MapFile("input.json");
+    } catch (const std::runtime_error&) {
+        std::cerr << "Error: unable to open input file." << std::endl;
+        return 1;
+    }
 
     // Создание объекта каталога для хранения информации о транспорте
     transport::Catalogue catalogue;
-    // Заполнение каталога данными о остановках и маршрутах из JSON
-    json_doc.FillCatalogue(catalogue);
+
+    // Создание объекта JsonReader для загрузки и обработки JSON.
+    // Раздел base_requests не превращается в узлы: декодер заполняет каталог остановками
+    // и маршрутами за тот же проход разбора (большой раздел - на нескольких потоках).
+    // Остальные разделы невелики и размещаются в арене с блоками размера по умолчанию
+    auto arena = std::make_unique<json::Arena>();
+    JsonReader json_doc(LoadWithBaseRequests(std::move(input), catalogue, threads, std::move(arena)));
+    ReportMemory(memory_report, "json load", { json_doc.GetDocument().GetMemoryUsage(), catalogue.GetMemoryUsage() });
     
     // Получение статистических запросов и настроек рендеринга из JSON-документа
     const auto& stat_requests = json_doc.GetStatRequests();
@@ -32,20 +88,42 @@ int main() {
     const auto& renderer = json_doc.FillRenderSettings(render_settings);
     
     // Получение настроек маршрутизации из JSON-документа
-    const auto& routing_settings = json_doc.FillRoutingSettings(json_doc.GetRoutingSettings());
+    auto routing_settings = json_doc.FillRoutingSettings(json_doc.GetRoutingSettings());
     
-    // Создание объекта маршрутизатора с использованием настроек и каталога
-    const transport::Router router = {routing_settings, catalogue};
+    // Публикация версии данных: каталог замораживается; маршрутизатор и карта строятся
+    // при первом запросе Route и Map. При перезагрузке данных новая версия публикуется так же,
+    // не останавливая обработку запросов
+    transport::SnapshotHolder snapshots;
+    snapshots.Publish(std::make_shared<transport::Snapshot>(std::move(catalogue), renderer, std::move(routing_settings), 1, threads));
+    const auto snapshot = snapshots.Acquire();
+    ReportMemory(memory_report, "snapshot publish", { snapshot->GetCatalogue().GetMemoryUsage() });
 
-    // Создание обработчика запросов с использованием каталога и настроек рендеринга
-    RequestHandler rh(catalogue, renderer, router);
+    // Создание обработчика запросов на текущей версии данных
+    RequestHandler rh(snapshot);
 
     // Обработка статистических запросов и вывод результатов
-    json_doc.ProcessRequests(stat_requests, rh);
+    if (ndjson) {
+        json_doc.ProcessRequestStream(std::cin, rh);
+    } else {
+        json_doc.ProcessRequests(stat_requests, rh);
+    }
+
+    if (snapshot->IsRouterBuilt()) {
+        ReportMemory(memory_report, "routing", { snapshot->GetRouter().GetMemoryUsage() });
+    }
+
+    // Вывод карты в XML-файл, если её запрашивали: отрисованная для ответа карта не перерисовывается
+    if (snapshot->IsMapRendered()) {
+        const std::string& map = snapshot->GetMapSvg();
+        ReportMemory(memory_report, "map render", { snapshot->GetMapMemoryUsage() });
 
-    // Вывод результата в XML-файл
-    rh.RenderMap().Render(output);
-    output.close();
+        std::fstream output("output.xml");
+        if (!output) {
+            std::cerr << "Error: unable to open output file." << std::endl;
+        }
+        output << map;
+        output.close();
+    }
     
     std::system("pause");
 
@@ -8,22 +8,24 @@ bool IsZero(double value) {
 }
 
 // Получение линий маршрутов для отображения 
-std::vector<svg::Polyline> MapRenderer::GetRouteLines(const std::map<std::string_view, const transport::Bus*>& buses, const SphereProjector& sp) const {
+std::vector<svg::Polyline> MapRenderer::GetRouteLines(const transport::Catalogue& catalogue, const SphereProjector& sp) const {
     std::vector<svg::Polyline> result;
     size_t color_num = 0; // Индекс для выбора цвета из палитры
 
-    for (const auto& [bus_number, bus] : buses) {
-        if (bus->stops.empty()) continue; // Пропустить автобус без остановок
-
-        std::vector<const transport::Stop*> route_stops{bus->stops.begin(), bus->stops.end()};
-        // Добавить обратный маршрут, если маршрут не круговой
-        if (!bus->is_circle) {
-            route_stops.insert(route_stops.end(), std::next(bus->stops.rbegin()), bus->stops.rend());
-        }
+    for (const transport::Bus* bus : catalogue.GetSortedAllBuses()) {
+        const auto route_stops = catalogue.GetBusStops(*bus);
+        if (route_stops.empty()) continue; // Пропустить автобус без остановок
 
         svg::Polyline line;
-        for (const auto& stop : route_stops) {
-            line.AddPoint(sp(stop->coordinates)); // Добавить точку маршрута в линию
+        for (const uint32_t stop_id : route_stops) {
+            line.AddPoint(sp(catalogue.GetCoordinates(catalogue.GetStop(stop_id)))); // Добавить точку маршрута в линию
+        }
+        // Добавить обратный маршрут, если маршрут не круговой
+        if (!catalogue.IsRoundTrip(*bus)) {
+            const auto reverse_end = std::make_reverse_iterator(route_stops.begin());
+            for (auto it = std::next(std::make_reverse_iterator(route_stops.end())); it != reverse_end; ++it) {
+                line.AddPoint(sp(catalogue.GetCoordinates(catalogue.GetStop(*it))));
+            }
         }
 
         // Настройка стиля линии
@@ -43,31 +45,34 @@ std::vector<svg::Polyline> MapRenderer::GetRouteLines(const std::map<std::string
 }
 
 // Получение меток автобусов для отображения 
-std::vector<svg::Text> MapRenderer::GetBusLabels(const std::map<std::string_view, const transport::Bus*>& buses, const SphereProjector& sp) const {
+std::vector<svg::Text> MapRenderer::GetBusLabels(const transport::Catalogue& catalogue, const SphereProjector& sp) const {
     std::vector<svg::Text> result;
     size_t color_num = 0; // Индекс для выбора цвета из палитры
 
-    for (const auto& [bus_number, bus] : buses) {
-        if (bus->stops.empty()) continue; // Пропустить автобус без остановок
+    for (const transport::Bus* bus : catalogue.GetSortedAllBuses()) {
+        const auto route_stops = catalogue.GetBusStops(*bus);
+        if (route_stops.empty()) continue; // Пропустить автобус без остановок
+        const uint32_t first_stop = *route_stops.begin();
+        const uint32_t last_stop = *std::prev(route_stops.end());
 
         // Настройка текста для метки автобуса
         svg::Text text;
         svg::Text underlayer;
-        text.SetPosition(sp(bus->stops[0]->coordinates));
+        text.SetPosition(sp(catalogue.GetCoordinates(catalogue.GetStop(first_stop))));
         text.SetOffset(render_settings_.bus_label_offset);
         text.SetFontSize(render_settings_.bus_label_font_size);
         text.SetFontFamily("Verdana");
         text.SetFontWeight("bold");
-        text.SetData(bus->number);
+        text.SetData(std::string(bus->number));
         text.SetFillColor(render_settings_.color_palette[color_num]);
 
         // Настройка подложки для текста
-        underlayer.SetPosition(sp(bus->stops[0]->coordinates));
+        underlayer.SetPosition(sp(catalogue.GetCoordinates(catalogue.GetStop(first_stop))));
         underlayer.SetOffset(render_settings_.bus_label_offset);
         underlayer.SetFontSize(render_settings_.bus_label_font_size);
         underlayer.SetFontFamily("Verdana");
         underlayer.SetFontWeight("bold");
-        underlayer.SetData(bus->number);
+        underlayer.SetData(std::string(bus->number));
         underlayer.SetFillColor(render_settings_.underlayer_color);
         underlayer.SetStrokeColor(render_settings_.underlayer_color);
         underlayer.SetStrokeWidth(render_settings_.underlayer_width);
@@ -78,11 +83,11 @@ std::vector<svg::Text> MapRenderer::GetBusLabels(const std::map<std::string_view
         result.push_back(text);
 
         // Добавление дополнительной метки для концов круговых маршрутов
-        if (!bus->is_circle && bus->stops[0] != bus->stops.back()) {
+        if (!catalogue.IsRoundTrip(*bus) && first_stop != last_stop) {
             svg::Text text2{text};
             svg::Text underlayer2{underlayer};
-            text2.SetPosition(sp(bus->stops.back()->coordinates));
-            underlayer2.SetPosition(sp(bus->stops.back()->coordinates));
+            text2.SetPosition(sp(catalogue.GetCoordinates(catalogue.GetStop(last_stop))));
+            underlayer2.SetPosition(sp(catalogue.GetCoordinates(catalogue.GetStop(last_stop))));
 
             result.push_back(underlayer2);
             result.push_back(text2);
@@ -96,12 +101,12 @@ std::vector<svg::Text> MapRenderer::GetBusLabels(const std::map<std::string_view
 }
 
 // Получение символов для отображения остановок 
-std::vector<svg::Circle> MapRenderer::GetStopSymbols(const std::map<std::string_view, const transport::Stop*>& stops, const SphereProjector& sp) const {
+std::vector<svg::Circle> MapRenderer::GetStopSymbols(const transport::Catalogue& catalogue, const std::vector<const transport::Stop*>& stops, const SphereProjector& sp) const {
     std::vector<svg::Circle> result;
 
-    for (const auto& [stop_name, stop] : stops) {
+    for (const transport::Stop* stop : stops) {
         svg::Circle symbol;
-        symbol.SetCenter(sp(stop->coordinates));
+        symbol.SetCenter(sp(catalogue.GetCoordinates(*stop)));
         symbol.SetRadius(render_settings_.stop_radius);
         symbol.SetFillColor("white");
 
@@ -112,27 +117,27 @@ std::vector<svg::Circle> MapRenderer::GetStopSymbols(const std::map<std::string_
 }
 
 // Получение меток для отображения остановок 
-std::vector<svg::Text> MapRenderer::GetStopLabels(const std::map<std::string_view, const transport::Stop*>& stops, const SphereProjector& sp) const {
+std::vector<svg::Text> MapRenderer::GetStopLabels(const transport::Catalogue& catalogue, const std::vector<const transport::Stop*>& stops, const SphereProjector& sp) const {
     std::vector<svg::Text> result;
 
-    for (const auto& [stop_name, stop] : stops) {
+    for (const transport::Stop* stop : stops) {
         svg::Text text;
         svg::Text underlayer;
 
         // Настройка текста для метки остановки
-        text.SetPosition(sp(stop->coordinates));
+        text.SetPosition(sp(catalogue.GetCoordinates(*stop)));
         text.SetOffset(render_settings_.stop_label_offset);
         text.SetFontSize(render_settings_.stop_label_font_size);
         text.SetFontFamily("Verdana");
-        text.SetData(stop->name);
+        text.SetData(std::string(stop->name));
         text.SetFillColor("black");
 
         // Настройка подложки для текста
-        underlayer.SetPosition(sp(stop->coordinates));
+        underlayer.SetPosition(sp(catalogue.GetCoordinates(*stop)));
         underlayer.SetOffset(render_settings_.stop_label_offset);
         underlayer.SetFontSize(render_settings_.stop_label_font_size);
         underlayer.SetFontFamily("Verdana");
-        underlayer.SetData(stop->name);
+        underlayer.SetData(std::string(stop->name));
         underlayer.SetFillColor(render_settings_.underlayer_color);
         underlayer.SetStrokeColor(render_settings_.underlayer_color);
         underlayer.SetStrokeWidth(render_settings_.underlayer_width);
@@ -147,46 +152,44 @@ std::vector<svg::Text> MapRenderer::GetStopLabels(const std::map<std::string_vie
 }
 
 // Вспомогательная функция для добавления линий маршрутов в SVG-документ
-void MapRenderer::AddRouteLinesToSVG(svg::Document& doc, const std::map<std::string_view, const transport::Bus*>& buses, const SphereProjector& sp) const {
-    for (const auto& line : GetRouteLines(buses, sp)) {
+void MapRenderer::AddRouteLinesToSVG(svg::Document& doc, const transport::Catalogue& catalogue, const SphereProjector& sp) const {
+    for (const auto& line : GetRouteLines(catalogue, sp)) {
         doc.Add(line);
     }
 }
 
 // Вспомогательная функция для добавления меток автобусов в SVG-документ
-void MapRenderer::AddBusLabelsToSVG(svg::Document& doc, const std::map<std::string_view, const transport::Bus*>& buses, const SphereProjector& sp) const {
-    for (const auto& text : GetBusLabels(buses, sp)) {
+void MapRenderer::AddBusLabelsToSVG(svg::Document& doc, const transport::Catalogue& catalogue, const SphereProjector& sp) const {
+    for (const auto& text : GetBusLabels(catalogue, sp)) {
         doc.Add(text);
     }
 }
 
 // Вспомогательная функция для добавления символов остановок в SVG-документ
-void MapRenderer::AddStopSymbolsToSVG(svg::Document& doc, const std::map<std::string_view, const transport::Stop*>& stops, const SphereProjector& sp) const {
-    for (const auto& circle : GetStopSymbols(stops, sp)) {
+void MapRenderer::AddStopSymbolsToSVG(svg::Document& doc, const transport::Catalogue& catalogue, const std::vector<const transport::Stop*>& stops, const SphereProjector& sp) const {
+    for (const auto& circle : GetStopSymbols(catalogue, stops, sp)) {
         doc.Add(circle);
     }
 }
 
 // Вспомогательная функция для добавления меток остановок в SVG-документ
-void MapRenderer::AddStopLabelsToSVG(svg::Document& doc, const std::map<std::string_view, const transport::Stop*>& stops, const SphereProjector& sp) const {
-    for (const auto& text : GetStopLabels(stops, sp)) {
+void MapRenderer::AddStopLabelsToSVG(svg::Document& doc, const transport::Catalogue& catalogue, const std::vector<const transport::Stop*>& stops, const SphereProjector& sp) const {
+    for (const auto& text : GetStopLabels(catalogue, stops, sp)) {
         doc.Add(text);
     }
 }
 
 // Получение SVG-документа для отображения карты
-svg::Document MapRenderer::GetSVG(const std::map<std::string_view, const transport::Bus*>& buses) const {
+svg::Document MapRenderer::GetSVG(const transport::Catalogue& catalogue) const {
     svg::Document result;
     std::vector<geo::Coordinates> route_stops_coord;
-    std::map<std::string_view, const transport::Stop*> all_stops;
-
-    // Сбор всех остановок и координат маршрутов
-    for (const auto& [bus_number, bus] : buses) {
-        if (bus->stops.empty()) continue;
-        for (const auto& stop : bus->stops) {
-            route_stops_coord.push_back(stop->coordinates);
-            all_stops[stop->name] = stop;
-        }
+    std::vector<const transport::Stop*> all_stops;
+
+    // Сбор остановок, через которые проходит хотя бы один маршрут, и их координат
+    for (const transport::Stop* stop : catalogue.GetSortedAllStops()) {
+        if (stop->buses_count == 0) continue;
+        route_stops_coord.push_back(catalogue.GetCoordinates(*stop));
+        all_stops.push_back(stop);
     }
 
     // Создание проектора для преобразования координат
@@ -196,10 +199,10 @@ svg::Document MapRenderer::GetSVG(const std::map<std::string_view, const transpo
     );
 
     // Добавление элементов SVG в документ
-    AddRouteLinesToSVG(result, buses, sp);
-    AddBusLabelsToSVG(result, buses, sp);
-    AddStopSymbolsToSVG(result, all_stops, sp);
-    AddStopLabelsToSVG(result, all_stops, sp);
+    AddRouteLinesToSVG(result, catalogue, sp);
+    AddBusLabelsToSVG(result, catalogue, sp);
+    AddStopSymbolsToSVG(result, catalogue, all_stops, sp);
+    AddStopLabelsToSVG(result, catalogue, all_stops, sp);
 
     return result;
 }
@@ -0,0 +1,49 @@
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace memory {
+
+namespace {
+
+void PrintPart(const Usage& usage, int indent, std::ostream& output) {
+    output << std::string(indent * 2, ' ') << usage.name << ": " << usage.bytes << " bytes";
+    if (usage.bytes >= 1024) {
+        output << " (" << std::fixed << std::setprecision(1) << usage.bytes / 1024.0 << " KiB)" << std::defaultfloat;
+    }
+    output << '\n';
+    for (const Usage& part : usage.parts) {
+        PrintPart(part, indent + 1, output);
+    }
+}
+
+} // namespace
+
+// Добавляет bytes к составляющей part_name
+Usage& Usage::Add(std::string_view part_name, size_t part_bytes) {
+    auto it = std::find_if(parts.begin(), parts.end(), [part_name](const Usage& part) {
+        return part.name == part_name;
+    });
+    if (it == parts.end()) {
+        parts.emplace_back(std::string(part_name));
+        it = std::prev(parts.end());
+    }
+    it->bytes += part_bytes;
+    bytes += part_bytes;
+    return *this;
+}
+
+// Добавляет вложенный отчёт как составляющую
+Usage& Usage::Add(Usage part) {
+    bytes += part.bytes;
+    parts.push_back(std::move(part));
+    return *this;
+}
+
+// Выводит отчёт деревом с отступами
+void Print(const Usage& usage, std::ostream& output) {
+    PrintPart(usage, 0, output);
+}
+
+} // namespace memory
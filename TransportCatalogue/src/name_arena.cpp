@@ -0,0 +1,95 @@
+#include "name_arena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace transport {
+
+// Возвращает идентификатор имени, добавляя его при первом обращении
+NameId NameArena::Intern(std::string_view name) {
+    // Поддерживаем заполненность таблицы не выше половины
+    if ((names_.size() + 1) * 2 > slots_.size()) {
+        Rehash(std::max<size_t>(16, slots_.size() * 2));
+    }
+
+    const size_t hash = std::hash<std::string_view>{}(name);
+    const size_t slot = FindSlot(name, hash);
+    if (slots_[slot] != NO_NAME) {
+        return slots_[slot];
+    }
+
+    const NameId id = static_cast<NameId>(names_.size());
+    names_.push_back(Store(name));
+    hashes_.push_back(hash);
+    slots_[slot] = id;
+    return id;
+}
+
+// Возвращает идентификатор имени или NO_NAME
+NameId NameArena::Find(std::string_view name) const {
+    if (slots_.empty()) {
+        return NO_NAME;
+    }
+    return slots_[FindSlot(name, std::hash<std::string_view>{}(name))];
+}
+
+std::string_view NameArena::GetName(NameId id) const {
+    return names_.at(id);
+}
+
+size_t NameArena::GetSize() const {
+    return names_.size();
+}
+
+memory::Usage NameArena::GetMemoryUsage() const {
+    memory::Usage usage{ "NameArena" };
+    usage.Add("blocks", blocks_bytes_ + memory::VectorBytes(blocks_));
+    usage.Add("names", memory::VectorBytes(names_));
+    usage.Add("hashes", memory::VectorBytes(hashes_));
+    usage.Add("slots", memory::VectorBytes(slots_));
+    return usage;
+}
+
+// Копирует символы имени в текущий блок, при необходимости заводя новый
+std::string_view NameArena::Store(std::string_view name) {
+    if (name.empty()) {
+        return {};
+    }
+    if (block_used_ + name.size() > BLOCK_SIZE) {
+        // Слишком длинные имена получают собственный блок
+        const size_t block_size = std::max(BLOCK_SIZE, name.size());
+        blocks_.push_back(std::make_unique<char[]>(block_size));
+        blocks_bytes_ += block_size;
+        block_used_ = 0;
+    }
+    char* data = blocks_.back().get() + block_used_;
+    std::memcpy(data, name.data(), name.size());
+    block_used_ += name.size();
+    return {data, name.size()};
+}
+
+// Линейное пробирование; размер таблицы всегда степень двойки
+size_t NameArena::FindSlot(std::string_view name, size_t hash) const {
+    const size_t mask = slots_.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const NameId id = slots_[slot];
+        if (id == NO_NAME || (hashes_[id] == hash && names_[id] == name)) {
+            return slot;
+        }
+    }
+}
+
+void NameArena::Rehash(size_t capacity) {
+    slots_.assign(capacity, NO_NAME);
+    const size_t mask = capacity - 1;
+    for (NameId id = 0; id < names_.size(); ++id) {
+        size_t slot = hashes_[id] & mask;
+        while (slots_[slot] != NO_NAME) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = id;
+    }
+}
+
+} // namespace transport
@@ -0,0 +1,225 @@
+#include "name_search.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+namespace transport {
+
+namespace {
+
+// Декодирует UTF-8 в кодовые точки. Байты, не образующие корректную последовательность,
+// передаются как отдельные символы со значением байта
+std::u32string DecodeUtf8(std::string_view text) {
+    std::u32string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        const auto lead = static_cast<unsigned char>(text[i]);
+        const size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        bool valid = length > 0 && i + length <= text.size();
+        char32_t code = length == 1 ? lead : lead & (0x7F >> length);
+        for (size_t j = 1; valid && j < length; ++j) {
+            const auto next = static_cast<unsigned char>(text[i + j]);
+            valid = (next >> 6) == 0x2;
+            code = (code << 6) | (next & 0x3F);
+        }
+        if (valid) {
+            result.push_back(code);
+            i += length;
+        } else {
+            result.push_back(lead);
+            ++i;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+NameSearchIndex::NameSearchIndex(const std::vector<std::string_view>& sorted_names) {
+    offsets_.reserve(sorted_names.size() + 1);
+    lcp_.reserve(sorted_names.size());
+    offsets_.push_back(0);
+    for (std::string_view name : sorted_names) {
+        const std::u32string chars = DecodeUtf8(name);
+        uint32_t lcp = 0;
+        if (offsets_.size() > 1) {
+            const auto previous = chars_.begin() + offsets_[offsets_.size() - 2];
+            const size_t common = std::min<size_t>(chars.size(), chars_.end() - previous);
+            lcp = static_cast<uint32_t>(std::mismatch(chars.begin(), chars.begin() + common, previous).first - chars.begin());
+        }
+        lcp_.push_back(lcp);
+        max_length_ = std::max(max_length_, static_cast<uint32_t>(chars.size()));
+        chars_.insert(chars_.end(), chars.begin(), chars.end());
+        offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+    }
+    chars_.shrink_to_fit();
+}
+
+// Возвращает не более limit имён, начало которых отличается от query не более чем на max_distance правок
+std::vector<NameMatch> NameSearchIndex::Find(std::string_view query, size_t limit, int max_distance) const {
+    if (max_distance < 0 || max_distance > MAX_DISTANCE) {
+        throw std::invalid_argument("unsupported edit distance");
+    }
+    if (limit == 0 || lcp_.empty()) {
+        return {};
+    }
+    const std::u32string chars = DecodeUtf8(query);
+    return max_distance == 0 ? FindPrefix(chars, limit) : FindFuzzy(chars, limit, max_distance);
+}
+
+memory::Usage NameSearchIndex::GetMemoryUsage() const {
+    memory::Usage usage{ "NameSearchIndex" };
+    usage.Add("chars", memory::VectorBytes(chars_));
+    usage.Add("offsets", memory::VectorBytes(offsets_));
+    usage.Add("lcp", memory::VectorBytes(lcp_));
+    return usage;
+}
+
+// Имена с заданным префиксом образуют непрерывный диапазон упорядоченного массива
+std::vector<NameMatch> NameSearchIndex::FindPrefix(const std::u32string& query, size_t limit) const {
+    auto name_begin = [this](uint32_t position) {
+        return chars_.begin() + offsets_[position];
+    };
+    auto name_end = [this](uint32_t position) {
+        return chars_.begin() + offsets_[position + 1];
+    };
+
+    // Первое имя, не меньшее query
+    uint32_t first = 0;
+    uint32_t count = static_cast<uint32_t>(lcp_.size());
+    while (count > 0) {
+        const uint32_t step = count / 2;
+        const uint32_t middle = first + step;
+        if (std::lexicographical_compare(name_begin(middle), name_end(middle), query.begin(), query.end())) {
+            first = middle + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    std::vector<NameMatch> result;
+    for (uint32_t position = first; position < lcp_.size() && result.size() < limit; ++position) {
+        if (GetLength(position) < query.size() || !std::equal(query.begin(), query.end(), name_begin(position))) {
+            break;
+        }
+        result.emplace_back(position, 0);
+    }
+    return result;
+}
+
+// Строка depth таблицы хранит расстояния от первых depth символов имени до каждого префикса query.
+// Расстояние от начала имени до query - наименьшее значение последнего столбца среди строк.
+// Если все значения строки больше max_distance, то же верно для всех последующих строк,
+// поэтому имена с таким префиксом получают уже известный результат без вычислений
+std::vector<NameMatch> NameSearchIndex::FindFuzzy(const std::u32string& query, size_t limit, int max_distance) const {
+    const size_t width = query.size() + 1;
+    const uint32_t max_length = max_length_;
+
+    // rows - строки таблицы для текущего имени, best[depth] - лучшее значение последнего столбца в строках 0..depth
+    std::vector<int> rows((max_length + 1) * width);
+    std::vector<int> best(max_length + 1);
+    for (size_t column = 0; column < width; ++column) {
+        rows[column] = static_cast<int>(column);
+    }
+    best[0] = static_cast<int>(query.size());
+
+    uint32_t computed = 0;  // Количество вычисленных строк, кроме нулевой
+
+    // matches - куча с худшим из найденных имён на вершине
+    std::vector<NameMatch> matches;
+    auto by_distance = [](const NameMatch& lhs, const NameMatch& rhs) {
+        return std::tie(lhs.second, lhs.first) < std::tie(rhs.second, rhs.first);
+    };
+
+    auto add_match = [&](uint32_t position, int distance) {
+        if (matches.size() < limit) {
+            matches.emplace_back(position, distance);
+            std::push_heap(matches.begin(), matches.end(), by_distance);
+        } else if (distance < matches.front().second) {
+            std::pop_heap(matches.begin(), matches.end(), by_distance);
+            matches.back() = { position, distance };
+            std::push_heap(matches.begin(), matches.end(), by_distance);
+        }
+    };
+
+    for (uint32_t position = 0; position < lcp_.size();) {
+        // Строки общего с предыдущим обработанным именем префикса уже вычислены
+        const uint32_t length = GetLength(position);
+        const auto name = chars_.begin() + offsets_[position];
+        bool dead = false;
+        for (uint32_t depth = std::min(lcp_[position], computed) + 1; depth <= length; ++depth) {
+            const int* previous = &rows[(depth - 1) * width];
+            int* current = &rows[depth * width];
+            const char32_t symbol = name[depth - 1];
+            current[0] = static_cast<int>(depth);
+            int row_min = current[0];
+            for (size_t column = 1; column < width; ++column) {
+                const int replace = previous[column - 1] + (query[column - 1] != symbol);
+                current[column] = std::min({ previous[column] + 1, current[column - 1] + 1, replace });
+                row_min = std::min(row_min, current[column]);
+            }
+            best[depth] = std::min(best[depth - 1], current[width - 1]);
+            computed = depth;
+            if (row_min > max_distance) {
+                dead = true;
+                break;
+            }
+        }
+        if (!dead) {
+            computed = length;
+        }
+
+        // Все имена с тем же префиксом длины computed получают то же расстояние;
+        // из них на результат могут повлиять только первые limit
+        const uint32_t end = dead ? GetSubtreeEnd(position, computed) : position + 1;
+        const int distance = best[computed];
+        if (distance <= max_distance) {
+            for (uint32_t match = position; match < end && match - position < limit; ++match) {
+                add_match(match, distance);
+            }
+        }
+        position = end;
+
+        // Следующие имена не могут оказаться лучше: расстояние не меньше нуля, а позиции больше
+        if (matches.size() == limit && matches.front().second == 0) {
+            break;
+        }
+    }
+
+    std::sort_heap(matches.begin(), matches.end(), by_distance);
+    return matches;
+}
+
+// Имена с общим префиксом идут подряд; конец их диапазона ищется сначала удвоением шага, затем делением пополам
+uint32_t NameSearchIndex::GetSubtreeEnd(uint32_t position, uint32_t depth) const {
+    const auto prefix = chars_.begin() + offsets_[position];
+    auto has_prefix = [&](uint32_t other) {
+        return GetLength(other) >= depth && std::equal(prefix, prefix + depth, chars_.begin() + offsets_[other]);
+    };
+
+    const uint32_t size = static_cast<uint32_t>(lcp_.size());
+    uint32_t inside = position;  // Последняя позиция, где префикс точно совпадает
+    uint32_t step = 1;
+    while (size - inside > step && has_prefix(inside + step)) {
+        inside += step;
+        step *= 2;
+    }
+    uint32_t outside = std::min(size, inside + step);  // Первая позиция, где префикс может уже не совпадать
+    while (outside - inside > 1) {
+        const uint32_t middle = inside + (outside - inside) / 2;
+        if (has_prefix(middle)) {
+            inside = middle;
+        } else {
+            outside = middle;
+        }
+    }
+    return outside;
+}
+
+uint32_t NameSearchIndex::GetLength(uint32_t position) const {
+    return offsets_[position + 1] - offsets_[position];
+}
+
+} // namespace transport
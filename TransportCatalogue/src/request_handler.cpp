@@ -10,10 +10,14 @@ std::optional<transport::BusStat> RequestHandler::GetBusStat(const std::string_v
     return catalogue_.GetRouteInfo(*bus);
 }
 
-const std::set<std::string> RequestHandler::GetBusesByStop(std::string_view stop_name) const { 
-    // Находим остановку по имени и возвращаем набор маршрутов, проходящих через эту остановку 
-    return catalogue_.FindStop(stop_name)->buses_by_stop; 
-} 
+transport::Catalogue::BusIdRange RequestHandler::GetBusesByStop(std::string_view stop_name) const {
+    // Находим остановку по имени и возвращаем отрезок маршрутов, проходящих через эту остановку
+    return catalogue_.GetBusesByStop(*catalogue_.FindStop(stop_name));
+}
+
+std::string_view RequestHandler::GetBusNumber(uint32_t bus_id) const {
+    return catalogue_.GetBus(bus_id).number;
+}
  
 bool RequestHandler::IsBusNumber(const std::string_view bus_number) const { 
     // Проверяем, существует ли маршрут с указанным номером 
@@ -26,16 +30,47 @@ bool RequestHandler::IsStopName(const std::string_view stop_name) const {
 } 
 
 const std::optional<graph::Router<double>::RouteInfo> RequestHandler::GetOptimalRoute(const std::string_view stop_from, const std::string_view stop_to) const {
+    // Находим остановки по имени без построения временных строк
+    const transport::Stop* from = catalogue_.FindStop(stop_from);
+    const transport::Stop* to = catalogue_.FindStop(stop_to);
+    if (!from || !to) {
+        return std::nullopt;
+    }
+
     // Возвращаем информацию о маршруте, если он существует
-    return router_.FindRoute(stop_from, stop_to);
+    return snapshot_->GetRouter().FindRoute(*from, *to);
+}
+
+std::vector<transport::Catalogue::NearbyStop> RequestHandler::GetNearbyStops(geo::Coordinates center, std::optional<double> radius, std::optional<size_t> count) const {
+    if (!radius) {
+        // Без радиуса ищем заданное количество ближайших остановок
+        return catalogue_.FindNearestStops(center, count.value_or(0));
+    }
+
+    auto stops = catalogue_.FindStopsWithinRadius(center, *radius);
+    if (count && stops.size() > *count) {
+        stops.resize(*count);
+    }
+    return stops;
+}
+
+std::vector<transport::Catalogue::StopMatch> RequestHandler::SearchStops(std::string_view query, size_t limit, int max_distance) const {
+    return catalogue_.SearchStops(query, limit, max_distance);
+}
+
+std::vector<transport::Catalogue::BusMatch> RequestHandler::SearchBuses(std::string_view query, size_t limit, int max_distance) const {
+    return catalogue_.SearchBuses(query, limit, max_distance);
 }
 
 const graph::DirectedWeightedGraph<double>& RequestHandler::GetRouterGraph() const {
     // Возвращаем ссылку на граф, используемый маршрутизатором
-    return router_.GetGraph();
+    return snapshot_->GetRouter().GetGraph();
+}
+
+bool RequestHandler::IsWalkEdge(graph::EdgeId edge_id) const {
+    return snapshot_->GetRouter().IsWalkEdge(edge_id);
+}
+
+const std::string& RequestHandler::GetMapSvg() const {
+    return snapshot_->GetMapSvg();
 }
- 
-svg::Document RequestHandler::RenderMap() const { 
-    // Получаем SVG-документ карты, используя все отсортированные маршруты 
-    return renderer_.GetSVG(catalogue_.GetSortedAllBuses()); 
-}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "snapshot.h"
+
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace transport {
+
+using namespace std::literals;
+
+namespace {
+
+// Замораживает каталог перед тем, как версия станет доступна для чтения
+Catalogue Frozen(Catalogue catalogue, size_t threads) {
+    catalogue.Freeze(threads);
+    return catalogue;
+}
+
+} // namespace
+
+Snapshot::Snapshot(Catalogue catalogue, const renderer::MapRenderer& renderer, Router routing_settings, uint64_t version,
+                   size_t threads)
+    : catalogue_(Frozen(std::move(catalogue), threads))
+    , renderer_(renderer)
+    , version_(version)
+    , router_(std::move(routing_settings)) {}
+
+const Catalogue& Snapshot::GetCatalogue() const {
+    return catalogue_;
+}
+
+const renderer::MapRenderer& Snapshot::GetRenderer() const {
+    return renderer_;
+}
+
+const Router& Snapshot::GetRouter() const {
+    std::call_once(router_once_, [this] {
+        router_.BuildGraph(catalogue_);
+        router_built_.store(true);
+    });
+    return router_;
+}
+
+bool Snapshot::IsRouterBuilt() const {
+    return router_built_.load();
+}
+
+const std::string& Snapshot::GetMapSvg() const {
+    std::call_once(map_once_, [this] {
+        const svg::Document document = renderer_.GetSVG(catalogue_);
+        std::ostringstream strm;
+        document.Render(strm);
+        map_svg_ = strm.str();
+        map_usage_ = memory::Usage{"MapRender"};
+        map_usage_.Add(document.GetMemoryUsage());
+        map_usage_.Add("svg text"sv, memory::StringBytes(map_svg_));
+        map_rendered_.store(true);
+    });
+    return map_svg_;
+}
+
+bool Snapshot::IsMapRendered() const {
+    return map_rendered_.load();
+}
+
+const memory::Usage& Snapshot::GetMapMemoryUsage() const {
+    return map_usage_;
+}
+
+uint64_t Snapshot::GetVersion() const {
+    return version_;
+}
+
+// Читатель отмечается в счётчике своей эпохи и проверяет, что эпоха не сменилась.
+// Пока он отмечен, писатель не отпустит версию, прочитанную из current_,
+// поэтому взять на неё shared_ptr через shared_from_this безопасно
+std::shared_ptr<const Snapshot> SnapshotHolder::Acquire() const {
+    while (true) {
+        const unsigned epoch = epoch_.load();
+        readers_[epoch].value.fetch_add(1);
+        if (epoch_.load() != epoch) {
+            // Писатель уже сменил эпоху и мог не увидеть нашу отметку - повторяем
+            readers_[epoch].value.fetch_sub(1);
+            continue;
+        }
+
+        const Snapshot* snapshot = current_.load();
+        std::shared_ptr<const Snapshot> result = snapshot ? snapshot->shared_from_this() : nullptr;
+        readers_[epoch].value.fetch_sub(1);
+        return result;
+    }
+}
+
+// Писатель подменяет указатель, переключает эпоху и ждёт читателей прошлой эпохи;
+// после этого ни один читатель не может обратиться к старой версии без собственной ссылки
+void SnapshotHolder::Publish(std::shared_ptr<const Snapshot> snapshot) {
+    std::lock_guard guard(publish_mutex_);
+
+    std::shared_ptr<const Snapshot> previous = std::move(owner_);
+    owner_ = std::move(snapshot);
+    current_.store(owner_.get());
+
+    const unsigned old_epoch = epoch_.load();
+    epoch_.store(old_epoch ^ 1u);
+    while (readers_[old_epoch].value.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    // Запросы, успевшие взять старую версию, удерживают её своими ссылками
+    previous.reset();
+}
+
+} // namespace transport
@@ -0,0 +1,264 @@
+#define _USE_MATH_DEFINES
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace geo {
+
+namespace {
+
+// Радиус Земли в метрах (как в ComputeDistance)
+constexpr double EARTH_RADIUS = 6371000.0;
+
+// Длина одного градуса широты в метрах
+constexpr double METERS_PER_DEGREE = EARTH_RADIUS * M_PI / 180.0;
+
+// Желаемое среднее количество точек в ячейке
+constexpr double POINTS_PER_CELL = 2.0;
+
+// Наименьший размер ячейки в метрах
+constexpr double MIN_CELL_SIZE = 10.0;
+
+// Запас на отличие равнопромежуточной проекции от расстояния по большому кругу
+constexpr double PROJECTION_MARGIN = 1.01;
+
+// Запас в метрах на погрешность вычисления расстояний и границ ячеек
+constexpr double DISTANCE_TOLERANCE = 1e-6;
+
+double CosDegrees(double degrees) {
+    return std::cos(degrees * M_PI / 180.0);
+}
+
+// Наименьшая разность долгот в градусах (от 0 до 180) между lng и долготами из отрезка [begin, end]
+double LongitudeGap(double lng, double begin, double end) {
+    // Отрезок сдвигается на целое число оборотов так, чтобы begin оказался в [lng, lng + 360)
+    const double shift = std::floor((begin - lng) / 360.0) * 360.0;
+    begin -= shift;
+    end -= shift;
+    if (end >= lng + 360.0) {
+        return 0.0;
+    }
+    return std::min(begin - lng, lng + 360.0 - end);
+}
+
+// Наименьшее расстояние в метрах от точки на широте lat до точек, долгота которых отличается
+// не меньше чем на gap градусов: до меридиана на разности gap (sin d = cos(lat) * sin(gap)),
+// а при gap от 90 градусов - до полюса
+double LongitudeGapDistance(double lat, double gap) {
+    const double sine = std::abs(CosDegrees(lat)) * std::sin(std::min(gap, 90.0) * M_PI / 180.0);
+    return std::asin(std::min(sine, 1.0)) * EARTH_RADIUS;
+}
+
+// Упорядочивание найденных точек: по расстоянию, при равенстве - по индексу
+bool ByDistance(const PointDistance& lhs, const PointDistance& rhs) {
+    return lhs.second < rhs.second || (lhs.second == rhs.second && lhs.first < rhs.first);
+}
+
+} // namespace
+
+GridIndex::GridIndex(const std::vector<Coordinates>& points) {
+    if (points.empty()) {
+        return;
+    }
+
+    const auto [bottom_it, top_it] = std::minmax_element(points.begin(), points.end(),
+        [](const Coordinates& lhs, const Coordinates& rhs) { return lhs.lat < rhs.lat; });
+    const auto [left_it, right_it] = std::minmax_element(points.begin(), points.end(),
+        [](const Coordinates& lhs, const Coordinates& rhs) { return lhs.lng < rhs.lng; });
+    min_lat_ = bottom_it->lat;
+    min_lng_ = left_it->lng;
+    const double max_lat = top_it->lat;
+    const double max_lng = right_it->lng;
+
+    // Размер ячейки в метрах выбираем по площади охватывающего прямоугольника
+    const double mid_cos = std::max(CosDegrees((min_lat_ + max_lat) / 2), 0.01);
+    const double height = (max_lat - min_lat_) * METERS_PER_DEGREE;
+    const double width = (max_lng - min_lng_) * METERS_PER_DEGREE * mid_cos;
+    const double target_cells = std::max(1.0, static_cast<double>(points.size()) / POINTS_PER_CELL);
+    double cell_size = (height > 0 && width > 0)
+        ? std::sqrt(height * width / target_cells)
+        : std::max(height, width) / target_cells;
+    cell_size = std::max(cell_size, MIN_CELL_SIZE);
+
+    cell_lat_ = cell_size / METERS_PER_DEGREE;
+    cell_lng_ = cell_size / (METERS_PER_DEGREE * mid_cos);
+    rows_ = static_cast<int>((max_lat - min_lat_) / cell_lat_) + 1;
+    columns_ = static_cast<int>((max_lng - min_lng_) / cell_lng_) + 1;
+
+    // Раскладываем индексы точек по ячейкам (CSR по номеру ячейки)
+    const size_t cells_count = static_cast<size_t>(rows_) * columns_;
+    std::vector<uint32_t> point_cells(points.size());
+    cell_offsets_.assign(cells_count + 1, 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points_.Add(points[i]);
+        const int row = std::clamp(GetRow(points[i].lat), 0, rows_ - 1);
+        const int column = std::clamp(GetColumn(points[i].lng), 0, columns_ - 1);
+        point_cells[i] = static_cast<uint32_t>(row * columns_ + column);
+        ++cell_offsets_[point_cells[i] + 1];
+    }
+    for (size_t cell = 0; cell < cells_count; ++cell) {
+        cell_offsets_[cell + 1] += cell_offsets_[cell];
+    }
+    cell_points_.resize(points.size());
+    std::vector<uint32_t> cursor(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    for (size_t i = 0; i < points.size(); ++i) {
+        cell_points_[cursor[point_cells[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+// Возвращает точки не дальше radius метров от center
+std::vector<PointDistance> GridIndex::FindWithinRadius(Coordinates center, double radius) const {
+    std::vector<PointDistance> result;
+    if (points_.GetSize() == 0 || radius < 0) {
+        return result;
+    }
+
+    // Охватывающий прямоугольник круга поиска в градусах
+    const double delta_lat = radius / METERS_PER_DEGREE;
+    const double max_abs_lat = std::abs(center.lat) + delta_lat;
+    const double lng_cos = max_abs_lat < 90 ? CosDegrees(max_abs_lat) : 0.0;
+    const double delta_lng = lng_cos > 0 ? delta_lat / lng_cos * PROJECTION_MARGIN : 360.0;
+
+    const int first_row = std::max(GetRow(center.lat - delta_lat), 0);
+    const int last_row = std::min(GetRow(center.lat + delta_lat), rows_ - 1);
+    const int first_column = std::max(GetColumn(center.lng - delta_lng), 0);
+    const int last_column = std::min(GetColumn(center.lng + delta_lng), columns_ - 1);
+    const SpherePoint center_point = ToSpherePoint(center);
+    for (int row = first_row; row <= last_row; ++row) {
+        CollectCells(row, first_column, last_column, center_point, radius, result);
+    }
+
+    std::sort(result.begin(), result.end(), ByDistance);
+    return result;
+}
+
+// Возвращает count ближайших точек. Ячейки обходятся кольцами вокруг ячейки центра;
+// обход прекращается, когда все непросмотренные ячейки заведомо дальше худшей из найденных точек
+std::vector<PointDistance> GridIndex::FindNearest(Coordinates center, size_t count) const {
+    std::vector<PointDistance> best;
+    if (points_.GetSize() == 0 || count == 0) {
+        return best;
+    }
+    count = std::min(count, points_.GetSize());
+    const SpherePoint center_point = ToSpherePoint(center);
+
+    const int center_row = GetRow(center.lat);
+    const int center_column = GetColumn(center.lng);
+
+    // Кольца, не пересекающие сетку, пропускаем сразу
+    const int first_ring = std::max({ 0, -center_row, center_row - (rows_ - 1), -center_column, center_column - (columns_ - 1) });
+    const int last_ring = std::max({ center_row, rows_ - 1 - center_row, center_column, columns_ - 1 - center_column });
+
+    static constexpr double ANY_DISTANCE = std::numeric_limits<double>::infinity();
+    std::vector<PointDistance> cell_points;
+    for (int ring = first_ring; ring <= last_ring; ++ring) {
+        // Кольца до ring - 1 включительно уже просмотрены
+        if (best.size() == count && ring > 0
+            && GetOutsideDistance(center, center_row, center_column, ring - 1) > best.front().second + DISTANCE_TOLERANCE) {
+            break;
+        }
+
+        cell_points.clear();
+        const int first_row = std::max(center_row - ring, 0);
+        const int last_row = std::min(center_row + ring, rows_ - 1);
+        // Верхняя и нижняя строки кольца просматриваются целиком, остальные - по двум крайним ячейкам
+        for (int row = first_row; row <= last_row; ++row) {
+            if (std::abs(row - center_row) == ring) {
+                CollectCells(row, std::max(center_column - ring, 0), std::min(center_column + ring, columns_ - 1), center_point, ANY_DISTANCE, cell_points);
+            } else {
+                for (const int column : { center_column - ring, center_column + ring }) {
+                    if (column >= 0 && column < columns_) {
+                        CollectCells(row, column, column, center_point, ANY_DISTANCE, cell_points);
+                    }
+                }
+            }
+        }
+
+        // best - куча с худшей из найденных точек на вершине
+        for (const PointDistance& point : cell_points) {
+            if (best.size() < count) {
+                best.push_back(point);
+                std::push_heap(best.begin(), best.end(), ByDistance);
+            } else if (ByDistance(point, best.front())) {
+                std::pop_heap(best.begin(), best.end(), ByDistance);
+                best.back() = point;
+                std::push_heap(best.begin(), best.end(), ByDistance);
+            }
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end(), ByDistance);
+    return best;
+}
+
+memory::Usage GridIndex::GetMemoryUsage() const {
+    memory::Usage usage{ "GridIndex" };
+    usage.Add(points_.GetMemoryUsage());
+    usage.Add("cell_offsets", memory::VectorBytes(cell_offsets_));
+    usage.Add("cell_points", memory::VectorBytes(cell_points_));
+    return usage;
+}
+
+// Номер вне сетки приводится к -1 или rows_ (columns_): этого достаточно всем вызывающим,
+// а приведение к int огромного значения (при большом радиусе или далёком центре) не определено.
+// NaN также даёт rows_ (columns_)
+int GridIndex::GetRow(double lat) const {
+    const double row = std::floor((lat - min_lat_) / cell_lat_);
+    return row < 0 ? -1 : row < rows_ ? static_cast<int>(row) : rows_;
+}
+
+int GridIndex::GetColumn(double lng) const {
+    const double column = std::floor((lng - min_lng_) / cell_lng_);
+    return column < 0 ? -1 : column < columns_ ? static_cast<int>(column) : columns_;
+}
+
+// Нижняя граница расстояния до точек вне квадрата. Точки севернее и южнее квадрата отстоят от center
+// не меньше чем на разность широт, восточнее и западнее - не меньше чем на расстояние до меридиана границы.
+// Стороны, за которыми нет ячеек сетки, не учитываются
+double GridIndex::GetOutsideDistance(Coordinates center, int row, int column, int half) const {
+    double distance = std::numeric_limits<double>::infinity();
+    if (row + half < rows_ - 1) {
+        const double north = min_lat_ + (row + half + 1) * cell_lat_;
+        distance = std::min(distance, std::max(north - center.lat, 0.0) * METERS_PER_DEGREE);
+    }
+    if (row - half > 0) {
+        const double south = min_lat_ + (row - half) * cell_lat_;
+        distance = std::min(distance, std::max(center.lat - south, 0.0) * METERS_PER_DEGREE);
+    }
+    const double max_lng = min_lng_ + columns_ * cell_lng_;
+    if (column + half < columns_ - 1) {
+        const double east = min_lng_ + (column + half + 1) * cell_lng_;
+        distance = std::min(distance, LongitudeGapDistance(center.lat, LongitudeGap(center.lng, east, max_lng)));
+    }
+    if (column - half > 0) {
+        const double west = min_lng_ + (column - half) * cell_lng_;
+        distance = std::min(distance, LongitudeGapDistance(center.lat, LongitudeGap(center.lng, min_lng_, west)));
+    }
+    return distance;
+}
+
+// Добавляет в result точки ячеек строки не дальше max_distance от center.
+// Расстояния считаются блоками фиксированного размера без выделения памяти
+void GridIndex::CollectCells(int row, int first_column, int last_column, SpherePoint center, double max_distance, std::vector<PointDistance>& result) const {
+    static constexpr size_t BLOCK = 256;
+    if (first_column > last_column) {
+        return;
+    }
+    const size_t row_begin = static_cast<size_t>(row) * columns_;
+    const size_t begin = cell_offsets_[row_begin + first_column];
+    const size_t end = cell_offsets_[row_begin + last_column + 1];
+    double distances[BLOCK];
+    for (size_t block = begin; block < end; block += BLOCK) {
+        const size_t count = std::min(BLOCK, end - block);
+        ComputeDistancesFrom(points_, center, cell_points_.data() + block, count, distances);
+        for (size_t i = 0; i < count; ++i) {
+            if (distances[i] <= max_distance) {
+                result.emplace_back(cell_points_[block + i], distances[i]);
+            }
+        }
+    }
+}
+
+} // namespace geo
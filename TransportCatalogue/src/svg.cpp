@@ -66,6 +66,10 @@ Circle& Circle::SetRadius(double radius) {
     return *this;
 }
 
+void Circle::AddMemoryUsage(memory::Usage& usage) const {
+    usage.Add("circles", sizeof(Circle) + GetAttrsMemory());
+}
+
 void Circle::RenderObject(const RenderContext& context) const {
     auto& out = context.out;
     out << "<circle cx=\""sv << center_.x << "\" cy=\""sv << center_.y << "\" "sv;
@@ -82,6 +86,10 @@ Polyline& Polyline::AddPoint(Point point) {
     return *this;
 }
 
+void Polyline::AddMemoryUsage(memory::Usage& usage) const {
+    usage.Add("polylines", sizeof(Polyline) + memory::VectorBytes(points_) + GetAttrsMemory());
+}
+
 void Polyline::RenderObject(const RenderContext& context) const {
     auto& out = context.out;
     out << "<polyline points=\""sv;
@@ -133,6 +141,11 @@ Text& Text::SetData(std::string data) {
     return *this;
 }
 
+void Text::AddMemoryUsage(memory::Usage& usage) const {
+    usage.Add("texts", sizeof(Text) + memory::StringBytes(font_family_) + memory::StringBytes(font_weight_)
+        + memory::StringBytes(data_) + GetAttrsMemory());
+}
+
 void Text::RenderObject(const RenderContext& context) const {
     auto& out = context.out;
     out << "<text";
@@ -162,4 +175,13 @@ void Document::Render(std::ostream& out) const {
     out << "</svg>"sv;
 }
 
+memory::Usage Document::GetMemoryUsage() const {
+    memory::Usage usage{"svg::Document"};
+    usage.Add("objects", memory::VectorBytes(objects_));
+    for (const auto& obj : objects_) {
+        obj->AddMemoryUsage(usage);
+    }
+    return usage;
+}
+
 }  // namespace svg
\ No newline at end of file
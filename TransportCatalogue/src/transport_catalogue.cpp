@@ -1,135 +1,486 @@
-#include "transport_catalogue.h" 
- 
-namespace transport { 
+#include "transport_catalogue.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <tuple>
+
+namespace transport {
+
+namespace {
+
+// Отметка «остановка ещё не встречалась» при подсчёте уникальных остановок
+constexpr uint32_t NO_MARK = std::numeric_limits<uint32_t>::max();
+
+// Длина списка смежности, до которой линейный поиск выгоднее двоичного
+constexpr std::ptrdiff_t LINEAR_SEARCH_LIMIT = 8;
+
+// Минимальное количество маршрутов на поток при параллельном подсчёте статистики
+constexpr size_t MIN_BUSES_PER_THREAD = 256;
+
+} // namespace
  
 // Добавляет остановку с указанным названием и координатами  
-void Catalogue::AddStop(std::string_view stop_name, const geo::Coordinates coordinates) { 
-    all_stops_.push_back({ std::string(stop_name), coordinates, {} }); 
-    stopname_to_stop_[all_stops_.back().name] = &all_stops_.back(); 
+void Catalogue::AddStop(std::string_view stop_name, const geo::Coordinates coordinates) {
+    CheckNotFrozen();
+    const NameId name_id = names_.Intern(stop_name);
+    all_stops_.push_back({ names_.GetName(name_id), static_cast<uint32_t>(all_stops_.size()) });
+    stop_lats_.push_back(coordinates.lat);
+    stop_lngs_.push_back(coordinates.lng);
+    stop_points_.Add(coordinates);
+    if (stop_by_name_.size() <= name_id) {
+        stop_by_name_.resize(name_id + 1, nullptr);
+    }
+    stop_by_name_[name_id] = &all_stops_.back();
 } 
      
 // Добавляет новый маршрут в каталог 
-void Catalogue::AddRoute(std::string_view bus_number, const std::vector<const Stop*>& stops, bool is_circle) {  
-    all_buses_.push_back({ std::string(bus_number), stops, is_circle });  
-      
-    busname_to_bus_[all_buses_.back().number] = &all_buses_.back();  
-  
-    // Обновляем отображение остановок на маршрутах  
-    for (const auto& route_stop : stops) {  
-        for (auto& stop_ : all_stops_) {  
-            if (stop_.name == route_stop->name) {  
-                stop_.buses_by_stop.insert(std::string(bus_number));  
-            }  
-        }  
-    }  
-}  
+void Catalogue::AddRoute(std::string_view bus_number, const std::vector<const Stop*>& stops, bool is_circle) {
+    CheckNotFrozen();
+    const NameId name_id = names_.Intern(bus_number);
+    const uint32_t bus_id = static_cast<uint32_t>(all_buses_.size());
+    all_buses_.push_back({ names_.GetName(name_id), bus_id, BusStat{} });
+
+    // Остановки и признак кольцевого маршрута дописываются в общие массивы каталога
+    for (const Stop* stop : stops) {
+        route_stops_.push_back(stop->id);
+    }
+    route_offsets_.push_back(static_cast<uint32_t>(route_stops_.size()));
+    if (round_trips_.size() * 64 <= bus_id) {
+        round_trips_.push_back(0);
+    }
+    if (is_circle) {
+        round_trips_[bus_id / 64] |= uint64_t{1} << (bus_id % 64);
+    }
+
+    if (bus_by_name_.size() <= name_id) {
+        bus_by_name_.resize(name_id + 1, nullptr);
+    }
+    bus_by_name_[name_id] = &all_buses_.back();
+}
  
 // Находит маршрут по номеру маршрута 
-const Bus* Catalogue::FindRoute(std::string_view bus_number) const { 
-    auto it = busname_to_bus_.find(bus_number); 
-    if (it == busname_to_bus_.end()) { 
-        return nullptr; 
-    } else { 
-        return it->second; 
-    } 
-} 
+const Bus* Catalogue::FindRoute(std::string_view bus_number) const {
+    const NameId name_id = names_.Find(bus_number);
+    if (name_id == NameArena::NO_NAME || name_id >= bus_by_name_.size()) {
+        return nullptr;
+    }
+    return bus_by_name_[name_id];
+}
  
 // Находит остановку по имени 
-const Stop* Catalogue::FindStop(std::string_view stop_name) const { 
-    auto it = stopname_to_stop_.find(stop_name); 
-    if (it == stopname_to_stop_.end()) { 
-        return nullptr; 
-    } else { 
-        return it->second; 
-    } 
-} 
- 
-// Возвращает количество уникальных остановок для указанного маршрута  
-size_t Catalogue::UniqueStopsCount(std::string_view bus_number) const { 
-    auto it = busname_to_bus_.find(bus_number); 
-    if (it == busname_to_bus_.end()) { 
-        return 0; 
-    } 
- 
-    std::unordered_set<std::string_view> unique_stops; 
-    for (const auto& stop : it->second->stops) { 
-        unique_stops.insert(stop->name); 
-    } 
-    return unique_stops.size(); 
-} 
- 
-// Устанавливает расстояние между двумя остановками 
-void Catalogue::SetDistance(const Stop* from, const Stop* to, const int distance) { 
-    stop_distances_[{from, to}] = distance; 
-} 
- 
-// Получает расстояние между двумя остановками 
-int Catalogue::GetDistance(const Stop* from, const Stop* to) const { 
-    auto it = stop_distances_.find({ from, to }); 
-    if (it != stop_distances_.end()) { 
-        return it->second; 
-    } 
- 
-    it = stop_distances_.find({ to, from }); 
-    if (it != stop_distances_.end()) { 
-        return it->second; 
-    } 
-    return 0; 
-} 
+const Stop* Catalogue::FindStop(std::string_view stop_name) const {
+    const NameId name_id = names_.Find(stop_name);
+    if (name_id == NameArena::NO_NAME || name_id >= stop_by_name_.size()) {
+        return nullptr;
+    }
+    return stop_by_name_[name_id];
+}
  
-// Возвращает все маршруты, отсортированные по номеру маршрута 
-const std::map<std::string_view, const Bus*> Catalogue::GetSortedAllBuses() const { 
-    std::map<std::string_view, const Bus*> result; 
-    for (const auto& bus : busname_to_bus_) { 
-        result.emplace(bus); 
-    } 
-    return result; 
-} 
+// Устанавливает расстояние между двумя остановками
+void Catalogue::SetDistance(const Stop* from, const Stop* to, const int distance) {
+    CheckNotFrozen();
+    pending_distances_.push_back({ from->id, to->id, distance });
+}
+
+// Получает расстояние между двумя остановками
+int Catalogue::GetDistance(const Stop* from, const Stop* to) const {
+    return GetDistance(from->id, to->id);
+}
+
+// Получает расстояние между двумя остановками по их идентификаторам
+int Catalogue::GetDistance(uint32_t from_id, uint32_t to_id) const {
+    // До заморозки индекс не построен, а линейный просмотр заданных расстояний слишком дорог
+    CheckFrozen();
+
+    // Обратное направление уже учтено при построении индекса
+    const auto begin = distance_targets_.begin() + distance_offsets_[from_id];
+    const auto end = distance_targets_.begin() + distance_offsets_[from_id + 1];
+    auto it = begin;
+    if (end - begin <= LINEAR_SEARCH_LIMIT) {
+        while (it != end && *it < to_id) {
+            ++it;
+        }
+    } else {
+        it = std::lower_bound(begin, end, to_id);
+    }
+    if (it == end || *it != to_id) {
+        return 0;
+    }
+    return distance_values_[it - distance_targets_.begin()];
+}
+
+// Возвращает все маршруты, отсортированные по номеру маршрута
+Catalogue::BusRange Catalogue::GetSortedAllBuses() const {
+    return ranges::AsRange(sorted_buses_);
+}
 
 // Возвращает все остановки, отсортированные по имени
-const std::map<std::string_view, const Stop*> Catalogue::GetSortedAllStops() const {
-    std::map<std::string_view, const Stop*> result;
-    for (const auto& stop : stopname_to_stop_) {
-        result.emplace(stop);
+Catalogue::StopRange Catalogue::GetSortedAllStops() const {
+    return ranges::AsRange(sorted_stops_);
+}
+
+// Получение статистики по маршруту
+transport::BusStat Catalogue::GetRouteInfo(const Bus& bus) const {
+    CheckFrozen();
+    return bus.stat;
+}
+
+// Вычисление статистики по маршруту
+transport::BusStat Catalogue::ComputeRouteInfo(const Bus& bus, RouteInfoBuffers& buffers) const {
+    BusStat bus_stat;
+    const StopIdRange stops = GetBusStops(bus);
+    if (stops.empty()) {
+        return bus_stat;
+    }
+    const bool is_circle = IsRoundTrip(bus);
+
+    // Уникальные остановки считаем по отметкам с номером маршрута вместо хеш-множества
+    for (const uint32_t stop_id : stops) {
+        if (buffers.stop_marks[stop_id] != bus.id) {
+            buffers.stop_marks[stop_id] = bus.id;
+            ++bus_stat.unique_stops_count;
+        }
+    }
+
+    if (is_circle) {
+        bus_stat.stops_count = stops.size();   // Круговой маршрут
+    } else {
+        bus_stat.stops_count = stops.size() * 2 - 1;   // Не круговой маршрут
+    }
+
+    int route_length = 0;             // Общая длина маршрута
+
+    // Подсчет длины маршрута по дорогам
+    for (auto it = stops.begin(); it + 1 != stops.end(); ++it) {
+        // Для кругового маршрута
+        route_length += GetDistance(it[0], it[1]);
+
+        // Для не кругового маршрута
+        if (!is_circle) {
+            route_length += GetDistance(it[1], it[0]);
+        }
+    }
+
+    // Географическая длина маршрута считается пакетно прямо по общему массиву остановок;
+    // для не кругового маршрута путь проходится дважды
+    double geographic_length = geo::ComputePathLength(stop_points_, route_stops_.data() + route_offsets_[bus.id], stops.size());
+    if (!is_circle) {
+        geographic_length *= 2;
+    }
+
+    bus_stat.route_length = route_length;
+    bus_stat.curvature = static_cast<double>(route_length) / geographic_length;
+
+    return bus_stat;
+}
+
+// Вычисляет статистику всех маршрутов. Маршруты независимы, поэтому делим их на непрерывные
+// диапазоны между потоками; каждый поток пишет только в статистику своих маршрутов
+void Catalogue::ComputeBusStats(size_t threads) {
+    const size_t threads_count = std::min(std::max<size_t>(threads, 1), all_buses_.size() / MIN_BUSES_PER_THREAD + 1);
+
+    auto compute_range = [this](size_t begin, size_t end) {
+        RouteInfoBuffers buffers;
+        buffers.stop_marks.assign(all_stops_.size(), NO_MARK);
+        for (size_t bus_id = begin; bus_id < end; ++bus_id) {
+            all_buses_[bus_id].stat = ComputeRouteInfo(all_buses_[bus_id], buffers);
+        }
+    };
+
+    const size_t chunk = (all_buses_.size() + threads_count - 1) / threads_count;
+    std::vector<std::thread> workers;
+    for (size_t begin = chunk; begin < all_buses_.size(); begin += chunk) {
+        workers.emplace_back(compute_range, begin, std::min(begin + chunk, all_buses_.size()));
+    }
+    compute_range(0, std::min(chunk, all_buses_.size()));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Завершает загрузку каталога и строит индексы только для чтения
+void Catalogue::Freeze(size_t threads) {
+    if (frozen_) {
+        return;
+    }
+    BuildDistancesIndex();
+    BuildSortedIndices();
+    BuildStopBusesIndex();
+    BuildStopIndex();
+    BuildSearchIndices();
+    ShrinkStorage();
+    // Индексы готовы, дальнейшие вычисления используют их
+    frozen_ = true;
+    ComputeBusStats(threads);
+}
+
+bool Catalogue::IsFrozen() const {
+    return frozen_;
+}
+
+// Возвращает идентификаторы автобусов, проходящих через остановку
+Catalogue::BusIdRange Catalogue::GetBusesByStop(const Stop& stop) const {
+    const auto begin = stop_buses_.begin() + stop.buses_offset;
+    return ranges::Range{begin, begin + stop.buses_count};
+}
+
+// Возвращает маршрут по его идентификатору
+const Bus& Catalogue::GetBus(uint32_t bus_id) const {
+    return all_buses_.at(bus_id);
+}
+
+// Возвращает остановку по её идентификатору
+const Stop& Catalogue::GetStop(uint32_t stop_id) const {
+    return all_stops_.at(stop_id);
+}
+
+// Возвращает координаты остановки
+geo::Coordinates Catalogue::GetCoordinates(const Stop& stop) const {
+    return { stop_lats_[stop.id], stop_lngs_[stop.id] };
+}
+
+// Возвращает идентификаторы остановок маршрута
+Catalogue::StopIdRange Catalogue::GetBusStops(const Bus& bus) const {
+    return ranges::Range{ route_stops_.begin() + route_offsets_[bus.id], route_stops_.begin() + route_offsets_[bus.id + 1] };
+}
+
+// Проверяет, является ли маршрут круговым
+bool Catalogue::IsRoundTrip(const Bus& bus) const {
+    return (round_trips_[bus.id / 64] >> (bus.id % 64)) & 1;
+}
+
+// Возвращает остановки не дальше radius метров от точки
+std::vector<Catalogue::NearbyStop> Catalogue::FindStopsWithinRadius(geo::Coordinates center, double radius) const {
+    return ToNearbyStops(stop_index_.FindWithinRadius(center, radius));
+}
+
+// Возвращает count ближайших к точке остановок
+std::vector<Catalogue::NearbyStop> Catalogue::FindNearestStops(geo::Coordinates center, size_t count) const {
+    return ToNearbyStops(stop_index_.FindNearest(center, count));
+}
+
+// Возвращает общее хранилище имён остановок и маршрутов
+const NameArena& Catalogue::GetNames() const {
+    return names_;
+}
+
+// Возвращает остановки, название которых начинается с query с точностью до max_distance опечаток
+std::vector<Catalogue::StopMatch> Catalogue::SearchStops(std::string_view query, size_t limit, int max_distance) const {
+    std::vector<StopMatch> result;
+    for (const auto& [position, distance] : stop_search_.Find(query, limit, max_distance)) {
+        result.emplace_back(sorted_stops_[position], distance);
     }
     return result;
 }
- 
-// Получение статистики по маршруту 
-transport::BusStat Catalogue::GetRouteInfo(const Bus& bus) const { 
-    BusStat bus_stat; 
-    bus_stat.unique_stops_count = std::unordered_set<const Stop*>(bus.stops.begin(), bus.stops.end()).size(); 
- 
-    if (bus.is_circle) { 
-        bus_stat.stops_count = bus.stops.size();   // Круговой маршрут 
-    } else { 
-        bus_stat.stops_count = bus.stops.size() * 2 - 1;   // Не круговой маршрут 
-    } 
- 
-    int route_length = 0;             // Общая длина маршрута 
-    double geographic_length = 0.0;   // Географическая длина маршрута 
- 
-    // Подсчет длины маршрута и географической длины 
-    for (size_t i = 0; i < bus.stops.size() - 1; ++i) { 
-        const Stop* from = bus.stops[i]; 
-        const Stop* to = bus.stops[i + 1]; 
-         
-        // Для кругового маршрута 
-        route_length += GetDistance(from, to); 
-        geographic_length += geo::ComputeDistance(from->coordinates, to->coordinates); 
- 
-        // Для не кругового маршрута 
-        if (!bus.is_circle) { 
-            route_length += GetDistance(to, from); 
-            geographic_length += geo::ComputeDistance(to->coordinates, from->coordinates); 
-        } 
-    } 
- 
-    bus_stat.route_length = route_length; 
-    bus_stat.curvature = static_cast<double>(route_length) / geographic_length; 
- 
-    return bus_stat; 
-} 
- 
- 
-} // namespace transport 
+
+// Возвращает маршруты, номер которых начинается с query с точностью до max_distance опечаток
+std::vector<Catalogue::BusMatch> Catalogue::SearchBuses(std::string_view query, size_t limit, int max_distance) const {
+    std::vector<BusMatch> result;
+    for (const auto& [position, distance] : bus_search_.Find(query, limit, max_distance)) {
+        result.emplace_back(sorted_buses_[position], distance);
+    }
+    return result;
+}
+
+// Занимаемая память с разбивкой по внутренним массивам и индексам
+memory::Usage Catalogue::GetMemoryUsage() const {
+    memory::Usage usage{ "Catalogue" };
+    usage.Add("buses", memory::DequeBytes(all_buses_));
+    usage.Add("stops", memory::DequeBytes(all_stops_));
+    usage.Add("stop_coordinates", memory::VectorBytes(stop_lats_) + memory::VectorBytes(stop_lngs_));
+    usage.Add("route_stops", memory::VectorBytes(route_stops_) + memory::VectorBytes(route_offsets_));
+    usage.Add("round_trips", memory::VectorBytes(round_trips_));
+    usage.Add("name_lookup", memory::VectorBytes(bus_by_name_) + memory::VectorBytes(stop_by_name_));
+    usage.Add("pending_distances", memory::VectorBytes(pending_distances_));
+    usage.Add("distances", memory::VectorBytes(distance_offsets_) + memory::VectorBytes(distance_targets_) + memory::VectorBytes(distance_values_));
+    usage.Add("sorted_indices", memory::VectorBytes(sorted_buses_) + memory::VectorBytes(sorted_stops_));
+    usage.Add("stop_buses", memory::VectorBytes(stop_buses_));
+    usage.Add(names_.GetMemoryUsage());
+    usage.Add(stop_points_.GetMemoryUsage());
+    usage.Add(stop_index_.GetMemoryUsage());
+    memory::Usage stop_search = stop_search_.GetMemoryUsage();
+    stop_search.name = "stop_search";
+    usage.Add(std::move(stop_search));
+    memory::Usage bus_search = bus_search_.GetMemoryUsage();
+    bus_search.name = "bus_search";
+    usage.Add(std::move(bus_search));
+    return usage;
+}
+
+// Заменяет индексы точек пространственного индекса на остановки
+std::vector<Catalogue::NearbyStop> Catalogue::ToNearbyStops(const std::vector<geo::PointDistance>& points) const {
+    std::vector<NearbyStop> result;
+    result.reserve(points.size());
+    for (const auto& [stop_id, distance] : points) {
+        result.emplace_back(&all_stops_[stop_id], distance);
+    }
+    return result;
+}
+
+void Catalogue::CheckNotFrozen() const {
+    if (frozen_) {
+        throw std::logic_error("catalogue is frozen");
+    }
+}
+
+void Catalogue::CheckFrozen() const {
+    if (!frozen_) {
+        throw std::logic_error("catalogue is not frozen");
+    }
+}
+
+// Строит списки смежности расстояний. Для пар, заданных только в одном направлении,
+// здесь же добавляется обратное направление, поэтому GetDistance выполняет один поиск
+void Catalogue::BuildDistancesIndex() {
+    auto by_stops = [](const StopDistance& lhs, const StopDistance& rhs) {
+        return std::tie(lhs.from, lhs.to) < std::tie(rhs.from, rhs.to);
+    };
+    auto same_stops = [](const StopDistance& lhs, const StopDistance& rhs) {
+        return lhs.from == rhs.from && lhs.to == rhs.to;
+    };
+
+    // Явно заданные расстояния; при повторном задании остаётся последнее значение
+    std::vector<StopDistance> distances = std::move(pending_distances_);
+    pending_distances_.clear();
+    std::reverse(distances.begin(), distances.end());
+    std::stable_sort(distances.begin(), distances.end(), by_stops);
+    distances.erase(std::unique(distances.begin(), distances.end(), same_stops), distances.end());
+
+    // Обратные направления, которые не заданы явно
+    const size_t explicit_count = distances.size();
+    for (size_t i = 0; i < explicit_count; ++i) {
+        const StopDistance reverse{ distances[i].to, distances[i].from, distances[i].distance };
+        if (!std::binary_search(distances.begin(), distances.begin() + explicit_count, reverse, by_stops)) {
+            distances.push_back(reverse);
+        }
+    }
+    std::sort(distances.begin() + explicit_count, distances.end(), by_stops);
+    std::inplace_merge(distances.begin(), distances.begin() + explicit_count, distances.end(), by_stops);
+
+    distance_offsets_.assign(all_stops_.size() + 1, 0);
+    distance_targets_.resize(distances.size());
+    distance_values_.resize(distances.size());
+    for (size_t i = 0; i < distances.size(); ++i) {
+        ++distance_offsets_[distances[i].from + 1];
+        distance_targets_[i] = distances[i].to;
+        distance_values_[i] = distances[i].distance;
+    }
+    std::partial_sum(distance_offsets_.begin(), distance_offsets_.end(), distance_offsets_.begin());
+}
+
+// Строит упорядоченные по имени списки. При совпадении имён остаётся объект, добавленный последним
+void Catalogue::BuildSortedIndices() {
+    auto build = [](const auto& objects, auto& sorted, auto get_name) {
+        sorted.clear();
+        sorted.reserve(objects.size());
+        for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+            sorted.push_back(&*it);
+        }
+        auto by_name = [get_name](const auto* lhs, const auto* rhs) {
+            return get_name(*lhs) < get_name(*rhs);
+        };
+        auto same_name = [get_name](const auto* lhs, const auto* rhs) {
+            return get_name(*lhs) == get_name(*rhs);
+        };
+        std::stable_sort(sorted.begin(), sorted.end(), by_name);
+        sorted.erase(std::unique(sorted.begin(), sorted.end(), same_name), sorted.end());
+        sorted.shrink_to_fit();
+    };
+    build(all_buses_, sorted_buses_, [](const Bus& bus) { return bus.number; });
+    build(all_stops_, sorted_stops_, [](const Stop& stop) { return stop.name; });
+}
+
+// Строит общий массив автобусов по остановкам (CSR по идентификатору остановки).
+// Учитываются все маршруты, включая повторно добавленные с тем же номером: остановка получает
+// номер, если через неё проходит любой из маршрутов с этим номером. Номер на остановке
+// записывается один раз (идентификатором первого из таких маршрутов)
+void Catalogue::BuildStopBusesIndex() {
+    static constexpr uint32_t NO_GROUP = std::numeric_limits<uint32_t>::max();
+
+    // Маршруты обходим в порядке номеров, тогда отрезок каждой остановки получается отсортированным.
+    // Маршруты с одинаковым номером соседствуют и образуют одну группу
+    std::vector<const Bus*> buses;
+    buses.reserve(all_buses_.size());
+    for (const Bus& bus : all_buses_) {
+        buses.push_back(&bus);
+    }
+    std::stable_sort(buses.begin(), buses.end(), [](const Bus* lhs, const Bus* rhs) {
+        return lhs->number < rhs->number;
+    });
+    std::vector<uint32_t> groups(buses.size());
+    for (size_t i = 1; i < buses.size(); ++i) {
+        groups[i] = groups[i - 1] + (buses[i]->number != buses[i - 1]->number ? 1 : 0);
+    }
+
+    // Первый проход: считаем количество различных номеров на каждой остановке
+    std::vector<uint32_t> last_group(all_stops_.size(), NO_GROUP);
+    for (size_t i = 0; i < buses.size(); ++i) {
+        for (const uint32_t stop_id : GetBusStops(*buses[i])) {
+            if (last_group[stop_id] != groups[i]) {
+                last_group[stop_id] = groups[i];
+                ++all_stops_[stop_id].buses_count;
+            }
+        }
+    }
+
+    uint32_t offset = 0;
+    for (Stop& stop : all_stops_) {
+        stop.buses_offset = offset;
+        offset += stop.buses_count;
+    }
+
+    // Второй проход: раскладываем идентификаторы автобусов по отрезкам остановок
+    stop_buses_.assign(offset, 0);
+    std::vector<uint32_t> cursor(all_stops_.size());
+    for (const Stop& stop : all_stops_) {
+        cursor[stop.id] = stop.buses_offset;
+    }
+    std::fill(last_group.begin(), last_group.end(), NO_GROUP);
+    for (size_t i = 0; i < buses.size(); ++i) {
+        for (const uint32_t stop_id : GetBusStops(*buses[i])) {
+            if (last_group[stop_id] != groups[i]) {
+                last_group[stop_id] = groups[i];
+                stop_buses_[cursor[stop_id]++] = buses[i]->id;
+            }
+        }
+    }
+}
+
+// Строит пространственный индекс остановок
+void Catalogue::BuildStopIndex() {
+    std::vector<geo::Coordinates> coordinates;
+    coordinates.reserve(all_stops_.size());
+    for (const Stop& stop : all_stops_) {
+        coordinates.push_back(GetCoordinates(stop));
+    }
+    stop_index_ = geo::GridIndex(coordinates);
+}
+
+// Строит индексы поиска по упорядоченным спискам имён
+void Catalogue::BuildSearchIndices() {
+    std::vector<std::string_view> names;
+    names.reserve(sorted_stops_.size());
+    for (const Stop* stop : sorted_stops_) {
+        names.push_back(stop->name);
+    }
+    stop_search_ = NameSearchIndex(names);
+
+    names.clear();
+    for (const Bus* bus : sorted_buses_) {
+        names.push_back(bus->number);
+    }
+    bus_search_ = NameSearchIndex(names);
+}
+
+// Освобождает запас ёмкости массивов, заполненных при загрузке
+void Catalogue::ShrinkStorage() {
+    stop_lats_.shrink_to_fit();
+    stop_lngs_.shrink_to_fit();
+    route_stops_.shrink_to_fit();
+    route_offsets_.shrink_to_fit();
+    round_trips_.shrink_to_fit();
+}
+
+} // namespace transport
@@ -4,25 +4,31 @@ namespace transport {
 
 // Строит граф маршрутизации на основе данных из каталога
 void Router::BuildGraph(const Catalogue& catalogue) {
-    std::map<std::string, graph::VertexId> stop_ids; 
-    graph::DirectedWeightedGraph<double> stops_graph(catalogue.GetSortedAllStops().size() * 2); 
+    std::vector<graph::VertexId> stop_vertices;
+    graph::DirectedWeightedGraph<double> stops_graph(catalogue.GetSortedAllStops().size() * 2);
 
 
-    AddStopEdges(stops_graph, catalogue, stop_ids);
-    AddBusEdges(stops_graph, catalogue, stop_ids);
+    AddStopEdges(stops_graph, catalogue, stop_vertices);
+    AddBusEdges(stops_graph, catalogue, stop_vertices);
+    walk_edges_begin_ = stops_graph.GetEdgeCount();
+    AddWalkEdges(stops_graph, catalogue, stop_vertices);
+    walk_edges_end_ = stops_graph.GetEdgeCount();
 
-    stop_ids_ = std::move(stop_ids);                             // Обновляем соответствие между остановками и идентификаторами вершин
+    stop_vertices_ = std::move(stop_vertices);                   // Обновляем соответствие между остановками и идентификаторами вершин
     graph_ = std::move(stops_graph);                             // Сохраняем построенный граф маршрутизации
     router_ = std::make_unique<graph::Router<double>>(graph_);   // Создаем объект маршрутизатора на основе построенного графа
 }
 
 // Добавляет рёбра для всех остановок в граф маршрутизации
-void Router::AddStopEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, std::map<std::string, graph::VertexId>& stop_ids) {
-    const auto& all_stops = catalogue.GetSortedAllStops(); 
-    graph::VertexId vertex_id = 0; 
+void Router::AddStopEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, std::vector<graph::VertexId>& stop_vertices) {
+    const auto all_stops = catalogue.GetSortedAllStops();
+    graph::VertexId vertex_id = 0;
 
-    for (const auto& [stop_name, stop_info] : all_stops) {
-        stop_ids[stop_info->name] = vertex_id; 
+    for (const Stop* stop_info : all_stops) {
+        if (stop_vertices.size() <= stop_info->id) {
+            stop_vertices.resize(stop_info->id + 1, NO_VERTEX);
+        }
+        stop_vertices[stop_info->id] = vertex_id;
         // Добавляем ребро для ожидания на остановке и посадки в автобус
         graph.AddEdge({
             stop_info->name,                    // Имя остановки
@@ -36,18 +42,19 @@ void Router::AddStopEdges(graph::DirectedWeightedGraph<double>& graph, const Cat
 }
 
 // Добавляет рёбра для всех автобусных маршрутов в граф маршрутизации
-void Router::AddBusEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, const std::map<std::string, graph::VertexId>& stop_ids) {
-    const auto& all_buses = catalogue.GetSortedAllBuses(); 
+void Router::AddBusEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, const std::vector<graph::VertexId>& stop_vertices) {
+    const auto all_buses = catalogue.GetSortedAllBuses();
 
-    for (const auto& item : all_buses) {
-        const auto& bus_info = item.second;   // Информация о текущем автобусном маршруте
-        const auto& stops = bus_info->stops;  // Список остановок на маршруте
-        size_t stops_count = stops.size();    // Количество остановок на маршруте
+    for (const Bus* bus_info : all_buses) {   // Информация о текущем автобусном маршруте
+        const auto route = catalogue.GetBusStops(*bus_info);      // Идентификаторы остановок на маршруте
+        const auto stops = route.begin();                          // Доступ к остановкам по номеру
+        size_t stops_count = route.size();                         // Количество остановок на маршруте
+        const bool is_circle = catalogue.IsRoundTrip(*bus_info);   // Является ли маршрут кольцевым
 
         for (size_t i = 0; i < stops_count; ++i) {
             for (size_t j = i + 1; j < stops_count; ++j) {
-                const Stop* stop_from = stops[i]; // Начальная остановка
-                const Stop* stop_to = stops[j];   // Конечная остановка
+                const uint32_t stop_from = stops[i]; // Начальная остановка
+                const uint32_t stop_to = stops[j];   // Конечная остановка
                 int dist_sum = 0;                 // Сумма расстояний в прямом направлении
                 int dist_sum_inverse = 0;         // Сумма расстояний в обратном направлении
 
@@ -57,25 +64,25 @@ void Router::AddBusEdges(graph::DirectedWeightedGraph<double>& graph, const Cata
                     dist_sum_inverse += catalogue.GetDistance(stops[k], stops[k - 1]);
                 }
 
-                auto it_from = stop_ids.find(stop_from->name);
-                auto it_to = stop_ids.find(stop_to->name);
+                const graph::VertexId vertex_from = stop_vertices[stop_from];
+                const graph::VertexId vertex_to = stop_vertices[stop_to];
 
-                if (it_from != stop_ids.end() && it_to != stop_ids.end()) {
+                if (vertex_from != NO_VERTEX && vertex_to != NO_VERTEX) {
                     graph.AddEdge({
                         bus_info->number,    // Номер маршрута
                         j - i,               // Количество остановок между начальной и конечной
-                        it_from->second + 1, // Начальная вершина (посадка в автобус)
-                        it_to->second,       // Конечная вершина (ожидание на остановке)
+                        vertex_from + 1,     // Начальная вершина (посадка в автобус)
+                        vertex_to,           // Конечная вершина (ожидание на остановке)
                         static_cast<double>(dist_sum) / (bus_velocity_ * (100.0 / 6.0)) // Время в пути
                     });
 
                     // Если маршрут не кольцевой, добавляем обратное ребро
-                    if (!bus_info->is_circle) {
+                    if (!is_circle) {
                         graph.AddEdge({
                             bus_info->number,  // Номер маршрута
                             j - i,             // Количество остановок между начальной и конечной
-                            it_to->second + 1, // Начальная вершина для обратного пути
-                            it_from->second,   // Конечная вершина для обратного пути
+                            vertex_to + 1,     // Начальная вершина для обратного пути
+                            vertex_from,       // Конечная вершина для обратного пути
                             static_cast<double>(dist_sum_inverse) / (bus_velocity_ * (100.0 / 6.0)) // Время в пути для обратного маршрута
                         });
                     }
@@ -85,26 +92,48 @@ void Router::AddBusEdges(graph::DirectedWeightedGraph<double>& graph, const Cata
     }
 }
 
+// Добавляет рёбра пеших переходов. Соседи каждой остановки берутся из пространственного индекса каталога,
+// поэтому построение занимает время, пропорциональное числу остановок и найденных пар, а не квадрату числа остановок
+void Router::AddWalkEdges(graph::DirectedWeightedGraph<double>& graph, const Catalogue& catalogue, const std::vector<graph::VertexId>& stop_vertices) {
+    if (walk_velocity_ <= 0 || max_walk_distance_ <= 0) {
+        return;
+    }
+
+    for (const Stop* stop_from : catalogue.GetSortedAllStops()) {
+        const graph::VertexId vertex_from = stop_vertices[stop_from->id];
+        for (const auto& [stop_to, distance] : catalogue.FindStopsWithinRadius(catalogue.GetCoordinates(*stop_from), max_walk_distance_)) {
+            const graph::VertexId vertex_to = stop_vertices[stop_to->id];
+            if (vertex_to == NO_VERTEX || vertex_to == vertex_from) {
+                continue;
+            }
+            graph.AddEdge({
+                stop_to->name,     // Остановка, к которой идёт пешеход
+                0,                 // Пеший переход не проезжает остановок
+                vertex_from,       // Начальная вершина (ожидание на исходной остановке)
+                vertex_to,         // Конечная вершина (ожидание на соседней остановке)
+                distance / (walk_velocity_ * (100.0 / 6.0)) // Время в пути пешком
+            });
+        }
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------------------
     
     
 // Находит оптимальный маршрут между двумя остановками и возвращает информацию о маршруте
-const std::optional<graph::Router<double>::RouteInfo> Router::FindRoute(const std::string_view stop_from, const std::string_view stop_to) const {
-    std::string from_str(stop_from);
-    std::string to_str(stop_to);
-
-    auto it_from = stop_ids_.find(from_str);
-    auto it_to = stop_ids_.find(to_str);
-
-    // Проверка, что обе остановки существуют в stop_ids_
-    if (it_from == stop_ids_.end() || it_to == stop_ids_.end()) {
+const std::optional<graph::Router<double>::RouteInfo> Router::FindRoute(const Stop& stop_from, const Stop& stop_to) const {
+    // Проверка, что обе остановки присутствуют в графе
+    if (stop_from.id >= stop_vertices_.size() || stop_to.id >= stop_vertices_.size()) {
         // Одна или обе остановки не найдены, маршрут не может быть построен
         return std::nullopt;
     }
 
-    // Получение идентификаторов вершин из найденных элементов
-    graph::VertexId vertex_from = it_from->second;
-    graph::VertexId vertex_to = it_to->second;
+    // Получение идентификаторов вершин по идентификаторам остановок
+    const graph::VertexId vertex_from = stop_vertices_[stop_from.id];
+    const graph::VertexId vertex_to = stop_vertices_[stop_to.id];
+    if (vertex_from == NO_VERTEX || vertex_to == NO_VERTEX) {
+        return std::nullopt;
+    }
 
     return router_->BuildRoute(vertex_from, vertex_to);
 }
@@ -114,4 +143,20 @@ const graph::DirectedWeightedGraph<double>& Router::GetGraph() const {
 	return graph_;
 }
 
+// Проверяет, является ли ребро пешим переходом между остановками
+bool Router::IsWalkEdge(graph::EdgeId edge_id) const {
+	return edge_id >= walk_edges_begin_ && edge_id < walk_edges_end_;
+}
+
+// Занимаемая память: граф, таблица маршрутов и соответствие остановок вершинам
+memory::Usage Router::GetMemoryUsage() const {
+	memory::Usage usage{ "transport::Router" };
+	usage.Add("stop_vertices", memory::VectorBytes(stop_vertices_));
+	usage.Add(graph_.GetMemoryUsage());
+	if (router_) {
+		usage.Add(router_->GetMemoryUsage());
+	}
+	return usage;
+}
+
 } // namespace transport
\ No newline at end of file